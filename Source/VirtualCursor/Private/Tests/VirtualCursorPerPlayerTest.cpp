@@ -0,0 +1,312 @@
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "VirtualCursor/CursorStateBuffer.h"
+#include "VirtualCursor/ExtendedAnalogCursor.h"
+#include "VirtualCursor/VirtualCursorManager.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/LocalPlayer.h"
+#include "Framework/Application/SlateUser.h"
+#include "Widgets/SViewport.h"
+
+#if WITH_EDITOR
+#include "Editor.h"
+#include "Settings/LevelEditorPlaySettings.h"
+#include "Tests/AutomationCommon.h"
+#include "Tests/AutomationEditorCommon.h"
+#endif
+
+
+/** Every cursor gets its own slot, whatever its controller id, and gives it back when released. */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVirtualCursorStateSlotTest, "VirtualCursor.PerPlayer.StateSlots", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVirtualCursorStateSlotTest::RunTest(const FString& Parameters)
+{
+	FVirtualCursorStateBuffer& StateBuffer = FVirtualCursorStateBuffer::Get();
+
+	// Live cursors may hold some slots already, so only the ones acquired here are checked
+	TArray<int32> Slots;
+	for (int32 Slot = StateBuffer.AcquireSlot(); Slot != INDEX_NONE; Slot = StateBuffer.AcquireSlot())
+	{
+		TestFalse(TEXT("Slot handed out twice"), Slots.Contains(Slot));
+		Slots.Add(Slot);
+	}
+	TestTrue(TEXT("At most MaxCursors slots"), Slots.Num() <= FVirtualCursorStateBuffer::MaxCursors);
+
+	// Two players with the same controller id, as in two PIE instances
+	for (int32 i = 0; i < Slots.Num(); ++i)
+	{
+		FVirtualCursorSnapshot Snapshot;
+		Snapshot.Position = FVector2D(100.0f * i, 50.0f);
+		Snapshot.UserIndex = 0;
+		Snapshot.bActive = true;
+		StateBuffer.Publish(Slots[i], Snapshot);
+	}
+	for (int32 i = 0; i < Slots.Num(); ++i)
+	{
+		FVirtualCursorSnapshot Snapshot;
+		if (TestTrue(TEXT("Published slot reads back"), StateBuffer.Read(Slots[i], Snapshot)))
+		{
+			TestTrue(TEXT("Slot keeps its own position"), Snapshot.Position.Equals(FVector2D(100.0f * i, 50.0f)));
+			TestEqual(TEXT("Snapshot records its slot"), Snapshot.StateSlot, Slots[i]);
+		}
+	}
+
+	// Handing a slot over and back, as the loading tick does, leaves the game thread able to write it
+	if (Slots.Num() > 0)
+	{
+		StateBuffer.ReleaseWriter(Slots[0]);
+		StateBuffer.ClaimWriter(Slots[0]);
+		StateBuffer.Retire(Slots[0]);
+
+		FVirtualCursorSnapshot Snapshot;
+		TestTrue(TEXT("Retired slot reads back"), StateBuffer.Read(Slots[0], Snapshot));
+		TestFalse(TEXT("Retired slot is inactive"), Snapshot.bActive);
+	}
+
+	for (const int32 Slot : Slots)
+	{
+		StateBuffer.ReleaseSlot(Slot);
+	}
+	if (Slots.Num() > 0)
+	{
+		const int32 Reacquired = StateBuffer.AcquireSlot();
+		TestTrue(TEXT("Released slots are handed out again"), Slots.Contains(Reacquired));
+		StateBuffer.ReleaseSlot(Reacquired);
+	}
+	return true;
+}
+
+
+#if WITH_EDITOR
+
+/** How many in-process clients VirtualCursor.PerPlayer.MultiClient starts */
+static const int32 NumTestClients = 4;
+
+/** Seconds to wait for every client to connect and get a player controller */
+static const double ClientStartTimeout = 60.0;
+
+/** Frames the cursors tick before their state is checked */
+static const int32 SettleFrames = 5;
+
+
+/** The first local player of every running PIE client, once it has a player controller and a viewport */
+static TArray<ULocalPlayer*> GetClientPlayers()
+{
+	TArray<ULocalPlayer*> Players;
+	for (const FWorldContext& Context : GEngine->GetWorldContexts())
+	{
+		UWorld* World = Context.World();
+		if (Context.WorldType != EWorldType::PIE || !World || World->GetNetMode() != NM_Client)
+			continue;
+
+		UGameInstance* GameInstance = World->GetGameInstance();
+		ULocalPlayer* LocalPlayer = GameInstance ? GameInstance->GetFirstGamePlayer() : nullptr;
+		if (LocalPlayer && LocalPlayer->ViewportClient && LocalPlayer->GetPlayerController(World))
+		{
+			Players.Add(LocalPlayer);
+		}
+	}
+	return Players;
+}
+
+
+/** Absolute bounds of the player's part of its own viewport, as the cursor resolves them */
+static bool GetPlayerRect(const FExtendedAnalogCursor& Cursor, FSlateRect& OutRect)
+{
+	FGeometry Geometry;
+	if (!Cursor.GetPlayerViewportGeometry(Geometry))
+		return false;
+
+	OutRect = FSlateRect(Geometry.LocalToAbsolute(FVector2D::ZeroVector), Geometry.LocalToAbsolute(Geometry.GetLocalSize()));
+	return true;
+}
+
+
+/** Lets the cursors tick for SettleFrames frames */
+static void AddSettleCommand()
+{
+	const TSharedRef<int32> Frames = MakeShared<int32>(0);
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([Frames]() { return ++(*Frames) > SettleFrames; }));
+}
+
+
+/**
+ * Starts NumTestClients clients in one process and gives each local player a cursor. Works headless under -nullrhi.
+ * Every cursor must get its own state slot and resolve its geometry inside its own game viewport rather than GEngine->GameViewport,
+ * and each one in turn must be centred in and clamped to that viewport.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVirtualCursorMultiClientTest, "VirtualCursor.PerPlayer.MultiClient", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FVirtualCursorMultiClientTest::RunTest(const FString& Parameters)
+{
+	if (!GEditor)
+	{
+		AddError(TEXT("Needs the editor to start a play session"));
+		return false;
+	}
+
+	FAutomationEditorCommonUtils::CreateNewMap();
+
+	ULevelEditorPlaySettings* PlaySettings = NewObject<ULevelEditorPlaySettings>();
+	PlaySettings->SetPlayNetMode(EPlayNetMode::PIE_Client);
+	PlaySettings->SetPlayNumberOfClients(NumTestClients);
+	PlaySettings->SetRunUnderOneProcess(true);
+
+	FRequestPlaySessionParams PlaySessionParams;
+	PlaySessionParams.EditorPlaySettings = PlaySettings;
+	GEditor->RequestPlaySession(PlaySessionParams);
+
+	struct FTestState
+	{
+		TArray<TWeakObjectPtr<ULocalPlayer>> Players;
+		double StartTime = 0.0;
+		bool bStarted = false;
+	};
+	const TSharedRef<FTestState> State = MakeShared<FTestState>();
+	State->StartTime = FPlatformTime::Seconds();
+
+	const auto GetManager = [State](const int32 Client) -> UVirtualCursorManager*
+	{
+		ULocalPlayer* LocalPlayer = State->Players.IsValidIndex(Client) ? State->Players[Client].Get() : nullptr;
+		return LocalPlayer ? LocalPlayer->GetSubsystem<UVirtualCursorManager>() : nullptr;
+	};
+
+	// The session starts on the next editor tick, and clients still have to connect
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, State]()
+	{
+		const TArray<ULocalPlayer*> Players = GetClientPlayers();
+		if (Players.Num() >= NumTestClients)
+		{
+			for (ULocalPlayer* LocalPlayer : Players)
+			{
+				State->Players.Add(LocalPlayer);
+			}
+			State->bStarted = true;
+			return true;
+		}
+
+		if (FPlatformTime::Seconds() - State->StartTime > ClientStartTimeout)
+		{
+			AddError(FString::Printf(TEXT("Only %d of %d clients started"), Players.Num(), NumTestClients));
+			return true;
+		}
+		return false;
+	}));
+
+	// Every client at once
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([State, GetManager]()
+	{
+		for (int32 Client = 0; State->bStarted && Client < State->Players.Num(); ++Client)
+		{
+			if (UVirtualCursorManager* Manager = GetManager(Client))
+			{
+				Manager->SetClampCursorToViewport(true);
+				Manager->EnableAnalogCursor();
+			}
+		}
+		return true;
+	}));
+	AddSettleCommand();
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, State, GetManager]()
+	{
+		TArray<int32> Slots;
+		TArray<SViewport*> Viewports;
+		for (int32 Client = 0; State->bStarted && Client < State->Players.Num(); ++Client)
+		{
+			const FString ClientName = FString::Printf(TEXT("Client %d"), Client);
+			const UVirtualCursorManager* Manager = GetManager(Client);
+			if (!TestTrue(ClientName + TEXT(" has an enabled cursor"), Manager && Manager->ContainsGamepadCursorInputProcessor()))
+				continue;
+
+			const TSharedPtr<FExtendedAnalogCursor> Cursor = Manager->GetCursor();
+			TestFalse(ClientName + TEXT(" shares its state slot"), Slots.Contains(Cursor->GetStateSlot()));
+			Slots.Add(Cursor->GetStateSlot());
+
+			const ULocalPlayer* LocalPlayer = State->Players[Client].Get();
+			const TSharedPtr<SViewport> ViewportWidget = LocalPlayer->ViewportClient->GetGameViewportWidget();
+			FSlateRect PlayerRect;
+			if (!TestTrue(ClientName + TEXT(" resolves its viewport geometry"), ViewportWidget.IsValid() && GetPlayerRect(*Cursor, PlayerRect)))
+				continue;
+
+			TestFalse(ClientName + TEXT(" shares its game viewport"), Viewports.Contains(ViewportWidget.Get()));
+			Viewports.Add(ViewportWidget.Get());
+
+			// The player's area is the whole viewport or a split screen part of it, never somewhere else on the desktop
+			const FSlateRect ViewportRect = ViewportWidget->GetCachedGeometry().GetLayoutBoundingRect().ExtendBy(FMargin(1.0f));
+			TestTrue(ClientName + TEXT(" geometry lies inside its own viewport"), FSlateRect::IsRectangleContained(ViewportRect, PlayerRect));
+		}
+		return true;
+	}));
+
+	// One client at a time from here, since clients with the same controller id share a Slate user and so the Slate cursor
+	for (int32 Client = 0; Client < NumTestClients; ++Client)
+	{
+		ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, State, GetManager, Client]()
+		{
+			UVirtualCursorManager* Manager = GetManager(Client);
+			if (!State->bStarted || !Manager)
+				return true;
+
+			for (int32 Other = 0; Other < State->Players.Num(); ++Other)
+			{
+				if (UVirtualCursorManager* OtherManager = GetManager(Other))
+				{
+					OtherManager->DisableAnalogCursor();
+				}
+			}
+			Manager->EnableAnalogCursor();
+
+			const FString ClientName = FString::Printf(TEXT("Client %d"), Client);
+			const TSharedPtr<FSlateUser> SlateUser = State->Players[Client]->GetSlateUser();
+			FSlateRect PlayerRect;
+			if (!SlateUser.IsValid() || !Manager->IsCursorValid() || !GetPlayerRect(*Manager->GetCursor(), PlayerRect))
+			{
+				AddError(ClientName + TEXT(" has no Slate user or viewport geometry"));
+				return true;
+			}
+
+			TestTrue(ClientName + TEXT(" cursor is centred in its viewport"), SlateUser->GetCursorPosition().Equals(PlayerRect.GetCenter(), 1.0f));
+
+			// Throw the cursor off the bottom right, the next ticks have to bring it back
+			SlateUser->SetCursorPosition(PlayerRect.GetBottomRight() + FVector2D(500.0f, 500.0f));
+			return true;
+		}));
+		AddSettleCommand();
+
+		ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([this, State, GetManager, Client]()
+		{
+			const UVirtualCursorManager* Manager = GetManager(Client);
+			FSlateRect PlayerRect;
+			if (State->bStarted && Manager && Manager->IsCursorValid() && GetPlayerRect(*Manager->GetCursor(), PlayerRect))
+			{
+				TestTrue(FString::Printf(TEXT("Client %d cursor is clamped to its viewport"), Client),
+					PlayerRect.ExtendBy(FMargin(1.0f)).ContainsPoint(Manager->GetCursor()->GetCurrentPosition()));
+			}
+			return true;
+		}));
+	}
+
+	ADD_LATENT_AUTOMATION_COMMAND(FFunctionLatentCommand([State, GetManager]()
+	{
+		for (int32 Client = 0; Client < State->Players.Num(); ++Client)
+		{
+			if (UVirtualCursorManager* Manager = GetManager(Client))
+			{
+				Manager->DisableAnalogCursor();
+			}
+		}
+		return true;
+	}));
+	ADD_LATENT_AUTOMATION_COMMAND(FEndPlayMapCommand());
+	return true;
+}
+
+#endif // WITH_EDITOR
+
+#endif
@@ -0,0 +1,119 @@
+#include "VirtualCursor/CursorFrameBudget.h"
+#include "VirtualCursor/CursorSettings.h"
+#include "Stats/Stats.h"
+
+
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Budget Used (ms)"), STAT_VirtualCursorBudgetUsed, STATGROUP_VirtualCursor);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Budget (ms)"), STAT_VirtualCursorBudget, STATGROUP_VirtualCursor);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deferred Hover"), STAT_VirtualCursorDeferredHover, STATGROUP_VirtualCursor);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Deferred Optional"), STAT_VirtualCursorDeferredOptional, STATGROUP_VirtualCursor);
+
+
+/** Weight of the newest sample in the moving averages */
+static const float AverageWeight = 0.1f;
+
+
+FVirtualCursorFrameBudget& FVirtualCursorFrameBudget::Get()
+{
+	static FVirtualCursorFrameBudget Instance;
+	return Instance;
+}
+
+
+float FVirtualCursorFrameBudget::GetBudgetMs() const
+{
+	return GetDefault<UCursorSettings>()->GetCursorFrameBudgetMs();
+}
+
+
+void FVirtualCursorFrameBudget::BeginFrameIfNeeded()
+{
+	if (CurrentFrame == GFrameCounter)
+		return;
+
+	LastFrameUsedMs = FPlatformTime::ToMilliseconds(GetUsedCycles());
+	for (int32 Priority = 0; Priority < NumPriorities; ++Priority)
+	{
+		AverageFrameCycles[Priority] = FMath::Lerp(AverageFrameCycles[Priority], static_cast<float>(UsedCycles[Priority]), AverageWeight);
+		if (Deferrals[Priority] > 0)
+		{
+			// The turn passes to the next of last frame's requesters, so it never sits with a slot nobody uses
+			for (int32 Step = 1; Step <= NumRequesters; ++Step)
+			{
+				const int32 Requester = (RoundRobinTurn[Priority] + Step) % NumRequesters;
+				if (Requesters[Priority] & (1u << Requester))
+				{
+					RoundRobinTurn[Priority] = Requester;
+					break;
+				}
+			}
+		}
+
+		LastFrameDeferrals[Priority] = Deferrals[Priority];
+		UsedCycles[Priority] = 0;
+		Deferrals[Priority] = 0;
+		Requesters[Priority] = 0;
+	}
+
+	SET_FLOAT_STAT(STAT_VirtualCursorBudgetUsed, LastFrameUsedMs);
+	SET_FLOAT_STAT(STAT_VirtualCursorBudget, GetBudgetMs());
+	SET_DWORD_STAT(STAT_VirtualCursorDeferredHover, LastFrameDeferrals[static_cast<int32>(ECursorWorkPriority::Hover)]);
+	SET_DWORD_STAT(STAT_VirtualCursorDeferredOptional, LastFrameDeferrals[static_cast<int32>(ECursorWorkPriority::Optional)]);
+
+	CurrentFrame = GFrameCounter;
+}
+
+
+uint32 FVirtualCursorFrameBudget::GetUsedCycles() const
+{
+	uint32 Total = 0;
+	for (int32 Priority = 0; Priority < NumPriorities; ++Priority)
+	{
+		Total += UsedCycles[Priority];
+	}
+	return Total;
+}
+
+
+bool FVirtualCursorFrameBudget::TryBegin(const ECursorWorkPriority Priority, const int32 StateSlot)
+{
+	BeginFrameIfNeeded();
+
+	const float BudgetMs = GetBudgetMs();
+	if (Priority == ECursorWorkPriority::Physics || BudgetMs <= 0.0f)
+		return true;
+
+	const int32 PriorityIndex = static_cast<int32>(Priority);
+	if (StateSlot >= 0 && StateSlot < NumRequesters)
+	{
+		Requesters[PriorityIndex] |= 1u << StateSlot;
+	}
+
+	// What the higher priorities are still expected to spend this frame, judging by recent frames
+	float ReservedCycles = 0.0f;
+	for (int32 Higher = 0; Higher < PriorityIndex; ++Higher)
+	{
+		ReservedCycles += FMath::Max(AverageFrameCycles[Higher] - UsedCycles[Higher], 0.0f);
+	}
+
+	const float BudgetCycles = BudgetMs / (FPlatformTime::GetSecondsPerCycle() * 1000.0);
+	if (GetUsedCycles() + ReservedCycles + AverageRunCycles[PriorityIndex] <= BudgetCycles)
+		return true;
+
+	// Over budget, but one player per frame still gets its turn
+	if (StateSlot == RoundRobinTurn[PriorityIndex])
+		return true;
+
+	++Deferrals[PriorityIndex];
+	return false;
+}
+
+
+void FVirtualCursorFrameBudget::Charge(const ECursorWorkPriority Priority, const uint32 Cycles)
+{
+	BeginFrameIfNeeded();
+
+	const int32 PriorityIndex = static_cast<int32>(Priority);
+	UsedCycles[PriorityIndex] += Cycles;
+	AverageRunCycles[PriorityIndex] = FMath::Lerp(AverageRunCycles[PriorityIndex], static_cast<float>(Cycles), AverageWeight);
+}
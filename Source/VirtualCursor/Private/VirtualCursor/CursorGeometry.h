@@ -0,0 +1,13 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Layout/SlateRect.h"
+
+
+/** Distance from Point to the closest point of Rect, 0 inside it */
+FORCEINLINE float DistanceToRect(const FSlateRect& Rect, const FVector2D& Point)
+{
+	const float DeltaX = FMath::Max3(Rect.Left - Point.X, 0.0f, Point.X - Rect.Right);
+	const float DeltaY = FMath::Max3(Rect.Top - Point.Y, 0.0f, Point.Y - Rect.Bottom);
+	return FMath::Sqrt((DeltaX * DeltaX) + (DeltaY * DeltaY));
+}
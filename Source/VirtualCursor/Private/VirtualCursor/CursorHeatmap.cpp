@@ -0,0 +1,108 @@
+#include "VirtualCursor/CursorHeatmap.h"
+#include "VirtualCursorPlugin.h"
+#include "Async/Async.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+
+
+/** Maps a normalized value to a black -> red -> yellow -> white ramp */
+static FColor HeatColor(const float Value)
+{
+	const float Clamped = FMath::Clamp(Value, 0.0f, 1.0f);
+	const FLinearColor Color(
+		FMath::Clamp(Clamped * 3.0f, 0.0f, 1.0f),
+		FMath::Clamp((Clamped * 3.0f) - 1.0f, 0.0f, 1.0f),
+		FMath::Clamp((Clamped * 3.0f) - 2.0f, 0.0f, 1.0f));
+	return Color.ToFColor(true);
+}
+
+
+/** Writes Grid as a PNG, normalized to its largest cell. Worker thread. */
+static void WriteHeatmapImage(IImageWrapperModule& ImageWrapperModule, const TArray<float>& Grid, const FIntPoint Resolution, const FString& Filename)
+{
+	float MaxValue = KINDA_SMALL_NUMBER;
+	for (const float Value : Grid)
+	{
+		MaxValue = FMath::Max(MaxValue, Value);
+	}
+
+	TArray<FColor> Pixels;
+	Pixels.SetNumUninitialized(Grid.Num());
+	for (int32 i = 0; i < Grid.Num(); ++i)
+	{
+		Pixels[i] = HeatColor(Grid[i] / MaxValue);
+	}
+
+	TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+	if (ImageWrapper.IsValid() && ImageWrapper->SetRaw(Pixels.GetData(), Pixels.Num() * sizeof(FColor), Resolution.X, Resolution.Y, ERGBFormat::BGRA, 8))
+	{
+		FFileHelper::SaveArrayToFile(ImageWrapper->GetCompressed(), *Filename);
+	}
+}
+
+
+void FCursorHeatmap::Reset(const FIntPoint InResolution)
+{
+	Resolution = FIntPoint(FMath::Max(InResolution.X, 1), FMath::Max(InResolution.Y, 1));
+	Layers.Empty();
+	CachedLayout = NAME_None;
+	CachedLayer = nullptr;
+}
+
+
+void FCursorHeatmap::Accumulate(const FName Layout, const FVector2D& ViewportPosition, const bool bMoving, const FName HoveredWidget, const float DeltaTime)
+{
+	if (!CachedLayer || CachedLayout != Layout)
+	{
+		CachedLayer = Layers.Find(Layout);
+		if (!CachedLayer)
+		{
+			// Warm-up: the only allocation a layout ever costs
+			CachedLayer = &Layers.Add(Layout);
+			CachedLayer->DwellSeconds.SetNumZeroed(Resolution.X * Resolution.Y);
+			CachedLayer->TravelSeconds.SetNumZeroed(Resolution.X * Resolution.Y);
+		}
+		CachedLayout = Layout;
+	}
+
+	const int32 CellX = FMath::Clamp(FMath::FloorToInt(ViewportPosition.X * Resolution.X), 0, Resolution.X - 1);
+	const int32 CellY = FMath::Clamp(FMath::FloorToInt(ViewportPosition.Y * Resolution.Y), 0, Resolution.Y - 1);
+	const int32 Cell = (CellY * Resolution.X) + CellX;
+
+	(bMoving ? CachedLayer->TravelSeconds : CachedLayer->DwellSeconds)[Cell] += DeltaTime;
+	CachedLayer->TotalSeconds += DeltaTime;
+
+	if (HoveredWidget != NAME_None)
+	{
+		CachedLayer->HoverSeconds.FindOrAdd(HoveredWidget) += DeltaTime;
+	}
+}
+
+
+void FCursorHeatmap::ExportAsync(const FString& Directory, const FString& Prefix) const
+{
+	// The image wrapper module has to be loaded on the game thread
+	IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+
+	Async(EAsyncExecution::ThreadPool, [&ImageWrapperModule, Layers = Layers, Resolution = Resolution, Directory, Prefix]()
+	{
+		FString HoverCsv = TEXT("Layout,Widget,HoverSeconds,LayoutSeconds\n");
+		for (const TPair<FName, FCursorHeatmapLayer>& Layer : Layers)
+		{
+			const FString LayoutName = Layer.Key == NAME_None ? TEXT("Viewport") : Layer.Key.ToString();
+			WriteHeatmapImage(ImageWrapperModule, Layer.Value.DwellSeconds, Resolution, FPaths::Combine(Directory, FString::Printf(TEXT("%s_%s_Dwell.png"), *Prefix, *LayoutName)));
+			WriteHeatmapImage(ImageWrapperModule, Layer.Value.TravelSeconds, Resolution, FPaths::Combine(Directory, FString::Printf(TEXT("%s_%s_Travel.png"), *Prefix, *LayoutName)));
+
+			for (const TPair<FName, float>& Hover : Layer.Value.HoverSeconds)
+			{
+				HoverCsv += FString::Printf(TEXT("%s,%s,%.3f,%.3f\n"), *LayoutName, *Hover.Key.ToString(), Hover.Value, Layer.Value.TotalSeconds);
+			}
+		}
+		FFileHelper::SaveStringToFile(HoverCsv, *FPaths::Combine(Directory, FString::Printf(TEXT("%s_Hover.csv"), *Prefix)));
+
+		UE_LOG(LogVirtualCursor, Log, TEXT("Exported %d cursor heatmap layouts to %s"), Layers.Num(), *Directory);
+	});
+}
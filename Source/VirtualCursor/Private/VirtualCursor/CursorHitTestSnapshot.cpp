@@ -0,0 +1,255 @@
+#include "VirtualCursor/CursorHitTestSnapshot.h"
+#include "VirtualCursor/CursorGeometry.h"
+#include "VirtualCursorPlugin.h"
+#include "Async/ParallelFor.h"
+#include "Blueprint/UserWidget.h"
+#include "Framework/Application/SlateApplication.h"
+#include "HAL/IConsoleManager.h"
+#include "Layout/ArrangedChildren.h"
+#include "Slate/SObjectWidget.h"
+#include "Widgets/SWindow.h"
+
+
+/** True if the widget's render transform does more than translate it, so its paint bounds are not its hit-testable area */
+static bool HasShapingRenderTransform(const SWidget& Widget)
+{
+	const TOptional<FSlateRenderTransform>& RenderTransform = Widget.GetRenderTransform();
+	if (!RenderTransform.IsSet())
+		return false;
+
+	float A, B, C, D;
+	RenderTransform->GetMatrix().GetMatrix(A, B, C, D);
+	return !FMath::IsNearlyEqual(A, 1.0f) || !FMath::IsNearlyZero(B) || !FMath::IsNearlyZero(C) || !FMath::IsNearlyEqual(D, 1.0f);
+}
+
+
+void FCursorHitTestSnapshot::Build(FSlateApplication& SlateApp)
+{
+	check(IsInGameThread());
+
+	// Reset keeps the allocations, so a stable UI builds without allocating
+	Entries.Reset();
+	InteractableRects.Reset();
+	InteractableTypes.Reset();
+	InteractableLayouts.Reset();
+	InteractableWidgets.Reset();
+	LayoutNames.Reset();
+	TransformedRects.Reset();
+
+	for (const TSharedRef<SWindow>& Window : SlateApp.GetInteractiveTopLevelWindows())
+	{
+		AddWindow(Window);
+	}
+}
+
+
+void FCursorHitTestSnapshot::AddWindow(const TSharedRef<SWindow>& Window)
+{
+	if (!Window->IsVisible() || Window->IsWindowMinimized())
+		return;
+
+	const FGeometry WindowGeometry = Window->GetWindowGeometryInScreen();
+	AddWidget(FArrangedWidget(Window, WindowGeometry), WindowGeometry.GetRenderBoundingRect(), INDEX_NONE, INDEX_NONE, false);
+
+	// Menus, popups and tooltips come after their parent, so they end up above it, the order LocateWindowUnderMouse tests them in
+	for (const TSharedRef<SWindow>& ChildWindow : Window->GetChildWindows())
+	{
+		AddWindow(ChildWindow);
+	}
+}
+
+
+void FCursorHitTestSnapshot::AddWidget(const FArrangedWidget& ArrangedWidget, const FSlateRect& ClipRect, int32 InteractableOwner, int32 LayoutIndex, bool bTransformed)
+{
+	static const FName ObjectWidgetType(TEXT("SObjectWidget"));
+
+	const TSharedRef<SWidget>& Widget = ArrangedWidget.Widget;
+	const EVisibility Visibility = Widget->GetVisibility();
+	if (!Visibility.IsVisible())
+		return;
+
+	// Paint bounds, which include the render transforms of this widget and everything above it
+	const FSlateRect PaintRect = ArrangedWidget.Geometry.GetRenderBoundingRect();
+	const FSlateRect Rect = PaintRect.IntersectionWith(ClipRect);
+	if (Rect.IsEmpty())
+		return;
+
+	bTransformed = bTransformed || HasShapingRenderTransform(*Widget);
+
+	// The outermost user widget names the layout
+	if (LayoutIndex == INDEX_NONE && Widget->GetType() == ObjectWidgetType)
+	{
+		UUserWidget* UserWidget = StaticCastSharedRef<SObjectWidget>(Widget)->GetWidgetObject();
+		LayoutIndex = LayoutNames.Add(UserWidget ? UserWidget->GetClass()->GetFName() : NAME_None);
+	}
+
+	if (Widget->IsInteractable())
+	{
+		InteractableOwner = InteractableRects.Add(PaintRect);
+		InteractableTypes.Add(Widget->GetType());
+		InteractableLayouts.Add(LayoutIndex);
+		InteractableWidgets.Add(Widget);
+	}
+
+	if (Visibility.IsHitTestVisible())
+	{
+		Entries.Add({ Rect, InteractableOwner, LayoutIndex });
+
+		// Rotated or scaled widgets only cover part of their bounds, which the Slate hittest knows and a rect doesn't
+		if (bTransformed)
+		{
+			TransformedRects.Add(Rect);
+		}
+	}
+
+	if (!Visibility.AreChildrenHitTestVisible())
+		return;
+
+	const FSlateRect ChildClipRect = Widget->GetClipping() != EWidgetClipping::Inherit ? Rect : ClipRect;
+
+	FArrangedChildren ArrangedChildren(EVisibility::Visible);
+	Widget->ArrangeChildren(ArrangedWidget.Geometry, ArrangedChildren);
+	for (int32 i = 0; i < ArrangedChildren.Num(); ++i)
+	{
+		AddWidget(ArrangedChildren[i], ChildClipRect, InteractableOwner, LayoutIndex, bTransformed);
+	}
+}
+
+
+int32 FCursorHitTestSnapshot::FindInteractable(const FVector2D& AbsolutePosition, const float CursorRadius, FName& OutLayoutName) const
+{
+	OutLayoutName = NAME_None;
+
+	// Topmost hit-testable widget under the point, the same widget the hittest grid bubbles from
+	for (int32 i = Entries.Num() - 1; i >= 0; --i)
+	{
+		const FEntry& Entry = Entries[i];
+		if (Entry.Rect.ContainsPoint(AbsolutePosition))
+		{
+			OutLayoutName = Entry.LayoutIndex != INDEX_NONE ? LayoutNames[Entry.LayoutIndex] : NAME_None;
+			if (Entry.InteractableOwner != INDEX_NONE || CursorRadius <= 0.0f)
+			{
+				return Entry.InteractableOwner;
+			}
+			break;
+		}
+	}
+
+	if (CursorRadius <= 0.0f)
+		return INDEX_NONE;
+
+	// Nothing interactable directly under the cursor, take the closest one within its radius
+	int32 ClosestIndex = INDEX_NONE;
+	float ClosestDistance = CursorRadius;
+	for (int32 i = 0; i < InteractableRects.Num(); ++i)
+	{
+		const float Distance = DistanceToRect(InteractableRects[i], AbsolutePosition);
+		if (Distance <= ClosestDistance)
+		{
+			ClosestDistance = Distance;
+			ClosestIndex = i;
+		}
+	}
+	return ClosestIndex;
+}
+
+
+bool FCursorHitTestSnapshot::NeedsSerialHitTest(const FVector2D& AbsolutePosition, const float CursorRadius) const
+{
+	for (const FSlateRect& Rect : TransformedRects)
+	{
+		if (DistanceToRect(Rect, AbsolutePosition) <= CursorRadius)
+			return true;
+	}
+	return false;
+}
+
+
+void FCursorHitTestSnapshot::GetHoverResult(const int32 InteractableIndex, const FName LayoutName, FCursorHoverResult& OutResult) const
+{
+	OutResult = FCursorHoverResult();
+	OutResult.LayoutName = LayoutName;
+
+	if (InteractableWidgets.IsValidIndex(InteractableIndex))
+	{
+		OutResult.Widget = InteractableWidgets[InteractableIndex];
+		OutResult.WidgetType = InteractableTypes[InteractableIndex];
+		OutResult.WidgetRect = InteractableRects[InteractableIndex];
+	}
+}
+
+
+/**
+ * VirtualCursor.BenchmarkHover [QueriesPerPlayer]
+ * Times hover resolution for 1 to 8 simulated players, serially through LocateWindowUnderMouse
+ * and in parallel against a snapshot (including the cost of building it), and logs the results.
+ */
+static FAutoConsoleCommand BenchmarkHoverCommand(
+	TEXT("VirtualCursor.BenchmarkHover"),
+	TEXT("Compares serial and parallel hover resolution for 1-8 players. Optional argument: queries per player (default 64)."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (!FSlateApplication::IsInitialized())
+			return;
+
+		FSlateApplication& SlateApp = FSlateApplication::Get();
+		const int32 QueriesPerPlayer = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 64;
+		const float CursorRadius = SlateApp.GetCursorRadius();
+
+		TArray<TSharedRef<SWindow>> Windows = SlateApp.GetInteractiveTopLevelWindows();
+		if (Windows.Num() == 0)
+			return;
+		const FSlateRect Bounds = Windows[0]->GetRectInScreen();
+
+		FRandomStream Random(1234);
+		TArray<FVector2D> Positions;
+		for (int32 i = 0; i < 8 * QueriesPerPlayer; ++i)
+		{
+			Positions.Add(FVector2D(Random.FRandRange(Bounds.Left, Bounds.Right), Random.FRandRange(Bounds.Top, Bounds.Bottom)));
+		}
+
+		for (int32 Players = 1; Players <= 8; Players *= 2)
+		{
+			const int32 NumQueries = Players * QueriesPerPlayer;
+			int32 Mismatches = 0;
+
+			TArray<FName> SerialTypes;
+			SerialTypes.SetNum(NumQueries);
+			const double SerialStart = FPlatformTime::Seconds();
+			for (int32 i = 0; i < NumQueries; ++i)
+			{
+				FWidgetPath WidgetPath = SlateApp.LocateWindowUnderMouse(Positions[i], Windows);
+				for (int32 j = WidgetPath.Widgets.Num() - 1; j >= 0; --j)
+				{
+					if (WidgetPath.Widgets[j].Widget->IsInteractable())
+					{
+						SerialTypes[i] = WidgetPath.Widgets[j].Widget->GetType();
+						break;
+					}
+				}
+			}
+			const double SerialSeconds = FPlatformTime::Seconds() - SerialStart;
+
+			TArray<int32> ParallelResults;
+			ParallelResults.SetNum(NumQueries);
+			const double ParallelStart = FPlatformTime::Seconds();
+			FCursorHitTestSnapshot Snapshot;
+			Snapshot.Build(SlateApp);
+			ParallelFor(NumQueries, [&](const int32 i)
+			{
+				FName LayoutName;
+				ParallelResults[i] = Snapshot.FindInteractable(Positions[i], CursorRadius, LayoutName);
+			});
+			const double ParallelSeconds = FPlatformTime::Seconds() - ParallelStart;
+
+			for (int32 i = 0; i < NumQueries; ++i)
+			{
+				FCursorHoverResult Result;
+				Snapshot.GetHoverResult(ParallelResults[i], NAME_None, Result);
+				Mismatches += Result.WidgetType != SerialTypes[i] ? 1 : 0;
+			}
+
+			UE_LOG(LogVirtualCursor, Display, TEXT("BenchmarkHover: %d players, %d queries: serial %.3f ms, snapshot + parallel %.3f ms, %d mismatches"),
+				Players, NumQueries, SerialSeconds * 1000.0, ParallelSeconds * 1000.0, Mismatches);
+		}
+	}));
@@ -0,0 +1,152 @@
+#include "VirtualCursor/CursorHoverPrefetch.h"
+#include "VirtualCursor/CursorFrameBudget.h"
+#include "VirtualCursor/CursorHitTestSnapshot.h"
+#include "VirtualCursor/ExtendedAnalogCursor.h"
+#include "VirtualCursor/VirtualCursorManager.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
+#include "Widgets/SWidget.h"
+
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Prefetch Predictions"), STAT_VirtualCursorPrefetchPredictions, STATGROUP_VirtualCursor);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Prefetch Hovers"), STAT_VirtualCursorPrefetchHovers, STATGROUP_VirtualCursor);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Prefetch Hit Rate (%)"), STAT_VirtualCursorPrefetchHitRate, STATGROUP_VirtualCursor);
+
+
+/** Below this speed, in absolute pixels per second, a cursor is treated as resting and nothing is predicted */
+static const float MinPredictionSpeed = 50.0f;
+
+
+void FCursorHoverPrefetcher::Update(const TArray<TWeakObjectPtr<UVirtualCursorManager>>& Managers, const FCursorHitTestSnapshot& Snapshot, const float Horizon)
+{
+	CursorStates.RemoveAll([](const FCursorState& State) { return !State.Cursor.IsValid(); });
+
+	const double Now = FPlatformTime::Seconds();
+
+	for (const TWeakObjectPtr<UVirtualCursorManager>& Manager : Managers)
+	{
+		if (!Manager.IsValid() || !Manager->ContainsGamepadCursorInputProcessor())
+			continue;
+
+		const TSharedPtr<FExtendedAnalogCursor> Cursor = Manager->GetCursor();
+		FCursorState* State = CursorStates.FindByPredicate([&Cursor](const FCursorState& Candidate) { return Candidate.Cursor == Cursor; });
+		if (!State)
+		{
+			State = &CursorStates.AddDefaulted_GetRef();
+			State->Cursor = Cursor;
+		}
+
+		// Score the hover the cursor's last Tick resolved against what was predicted before it
+		const TSharedPtr<SWidget> Hovered = Cursor->GetHoveredWidget().Pin();
+		if (Hovered.IsValid() && Hovered != State->Hovered.Pin())
+		{
+			++HoverCount;
+			if (Hovered == State->Predicted.Pin())
+			{
+				++HitCount;
+			}
+
+			// Heading for the same widget again later is a new prediction
+			State->Predicted.Reset();
+		}
+		State->Hovered = Hovered;
+
+		// A cursor that did not arrive within the horizon has changed course or stopped short
+		if (Now - State->PredictedTime > Horizon)
+		{
+			State->Predicted.Reset();
+		}
+
+		const FVector2D Velocity = Cursor->GetVelocity();
+		if (!Cursor->GetIsUsingAnalogCursor() || Velocity.SizeSquared() < FMath::Square(MinPredictionSpeed))
+			continue;
+
+		float Time = 0.0f;
+		const int32 Index = FindFirstEntered(Snapshot, Cursor->GetCurrentPosition(), Velocity * Horizon, Time);
+		if (Index == INDEX_NONE)
+			continue;
+
+		FCursorHoverResult Predicted;
+		Snapshot.GetHoverResult(Index, NAME_None, Predicted);
+		const TSharedPtr<SWidget> PredictedWidget = Predicted.Widget.Pin();
+		if (!PredictedWidget.IsValid() || PredictedWidget == Hovered || PredictedWidget == State->Predicted.Pin())
+			continue;
+
+		State->Predicted = PredictedWidget;
+		State->PredictedTime = Now;
+		++PredictionCount;
+		Prefetch(Manager.Get(), PredictedWidget.ToSharedRef(), Time * Horizon);
+	}
+
+	SET_DWORD_STAT(STAT_VirtualCursorPrefetchPredictions, PredictionCount);
+	SET_DWORD_STAT(STAT_VirtualCursorPrefetchHovers, HoverCount);
+	SET_FLOAT_STAT(STAT_VirtualCursorPrefetchHitRate, HoverCount > 0 ? 100.0f * HitCount / HoverCount : 0.0f);
+}
+
+
+int32 FCursorHoverPrefetcher::FindFirstEntered(const FCursorHitTestSnapshot& Snapshot, const FVector2D& Start, const FVector2D& Delta, float& OutTime)
+{
+	int32 FirstIndex = INDEX_NONE;
+	OutTime = 1.0f;
+
+	const TArray<FSlateRect>& Rects = Snapshot.GetInteractableRects();
+	for (int32 i = 0; i < Rects.Num(); ++i)
+	{
+		const FSlateRect& Rect = Rects[i];
+
+		// Already inside it, so it is hovered rather than about to be
+		if (Rect.ContainsPoint(Start))
+			continue;
+
+		// Slab test of the segment against the rect, as fractions of Delta
+		float Enter = 0.0f;
+		float Exit = OutTime;
+		bool bMisses = false;
+		for (int32 Axis = 0; Axis < 2 && !bMisses; ++Axis)
+		{
+			const float Min = Axis == 0 ? Rect.Left : Rect.Top;
+			const float Max = Axis == 0 ? Rect.Right : Rect.Bottom;
+			if (FMath::IsNearlyZero(Delta[Axis]))
+			{
+				bMisses = Start[Axis] < Min || Start[Axis] > Max;
+				continue;
+			}
+
+			const float T0 = (Min - Start[Axis]) / Delta[Axis];
+			const float T1 = (Max - Start[Axis]) / Delta[Axis];
+			Enter = FMath::Max(Enter, FMath::Min(T0, T1));
+			Exit = FMath::Min(Exit, FMath::Max(T0, T1));
+			bMisses = Enter > Exit;
+		}
+
+		if (!bMisses && Enter < OutTime)
+		{
+			OutTime = Enter;
+			FirstIndex = i;
+		}
+	}
+	return FirstIndex;
+}
+
+
+void FCursorHoverPrefetcher::Prefetch(UVirtualCursorManager* Manager, const TSharedRef<SWidget>& Widget, const float TimeToHover)
+{
+	// Registration may be on an enclosing user widget rather than on the interactable itself
+	TSharedPtr<FCursorPrefetchMetaData> MetaData;
+	for (TSharedPtr<SWidget> Current = Widget; Current.IsValid() && !MetaData.IsValid(); Current = Current->GetParentWidget())
+	{
+		MetaData = Current->GetMetaData<FCursorPrefetchMetaData>();
+	}
+	if (!MetaData.IsValid())
+		return;
+
+	if (!MetaData->Handle.IsValid() && MetaData->Assets.Num() > 0 && UAssetManager::IsValid())
+	{
+		MetaData->Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(MetaData->Assets, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+	}
+
+	if (MetaData->Widget.IsValid())
+	{
+		Manager->OnWidgetAboutToBeHovered.Broadcast(MetaData->Widget.Get(), TimeToHover);
+	}
+}
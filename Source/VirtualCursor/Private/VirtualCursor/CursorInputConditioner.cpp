@@ -0,0 +1,150 @@
+#include "VirtualCursor/CursorInputConditioner.h"
+
+
+/** Smoothing factor of a first order low-pass filter with the given cutoff (Hz) */
+static float GetLowPassAlpha(const float Cutoff, const float DeltaTime)
+{
+	const float Tau = 1.0f / (2.0f * PI * Cutoff);
+	return 1.0f / (1.0f + (Tau / DeltaTime));
+}
+
+
+FCursorInputConditioner::FCursorInputConditioner()
+	: InnerThreshold(0.0f)
+	, AxialDeadZone(0.0f)
+	, InnerDeadZone(0.0f)
+	, OuterDeadZone(1.0f)
+	, AntiDeadZone(0.0f)
+	, bScaledRadial(false)
+	, bUseJitterFilter(false)
+	, FilterMinCutoff(1.0f)
+	, FilterBeta(0.0f)
+	, FilterDerivativeCutoff(1.0f)
+	, FilteredValue(FVector2D::ZeroVector)
+	, FilteredDerivative(FVector2D::ZeroVector)
+	, bFilterPrimed(false)
+	, bDiffersFromLegacy(false)
+	, CompiledRevision(0)
+{
+	FMemory::Memzero(ResponseTable);
+	FMemory::Memzero(LegacyTable);
+}
+
+
+void FCursorInputConditioner::Compile(const FCursorConditioningParams& Params, const uint32 Revision)
+{
+	InnerDeadZone = Params.InnerDeadZone;
+	OuterDeadZone = Params.OuterDeadZone;
+	AntiDeadZone = Params.AntiDeadZone;
+	bScaledRadial = Params.bScaledRadial;
+	AxialDeadZone = Params.AxialDeadZone;
+
+	bUseJitterFilter = Params.bUseJitterFilter;
+	FilterMinCutoff = Params.FilterMinCutoff;
+	FilterBeta = Params.FilterBeta;
+	FilterDerivativeCutoff = Params.FilterDerivativeCutoff;
+
+	InnerThreshold = InnerDeadZone;
+	for (int32 i = 0; i <= TableResolution; ++i)
+	{
+		const float Magnitude = (MaxMagnitude * i) / TableResolution;
+
+		// Never sample inside the dead zone, so the entry straddling it doesn't blend towards zero
+		const float OutsideDeadZone = FMath::Max<float>(Magnitude, InnerThreshold + KINDA_SMALL_NUMBER);
+		ResponseTable[i] = Params.Curve ? EvaluateStaticStages(*Params.Curve, OutsideDeadZone) : 0.0f;
+		LegacyTable[i] = Params.Curve ? Params.Curve->Eval(OutsideDeadZone) : 0.0f;
+	}
+
+	bDiffersFromLegacy = bUseJitterFilter || bScaledRadial || AxialDeadZone > 0.0f || OuterDeadZone < 1.0f || AntiDeadZone > 0.0f;
+	CompiledRevision = Revision;
+	ResetFilter();
+}
+
+
+float FCursorInputConditioner::SampleTable(const float (&Table)[TableResolution + 1], const float Magnitude)
+{
+	const float TablePosition = (FMath::Min<float>(Magnitude, MaxMagnitude) / MaxMagnitude) * TableResolution;
+	const int32 Index = FMath::Min<int32>(FMath::FloorToInt(TablePosition), TableResolution - 1);
+	return FMath::Lerp(Table[Index], Table[Index + 1], TablePosition - Index);
+}
+
+
+float FCursorInputConditioner::EvaluateStaticStages(const FRichCurve& Curve, float Magnitude) const
+{
+	if (Magnitude <= InnerDeadZone)
+		return 0.0f;
+
+	if (Magnitude >= OuterDeadZone)
+	{
+		// Legacy behaviour fed anything past the dead zone straight to the curve, keep doing so when there is no outer dead zone
+		Magnitude = (OuterDeadZone >= 1.0f && !bScaledRadial) ? Magnitude : 1.0f;
+	}
+	else if (bScaledRadial)
+	{
+		Magnitude = (Magnitude - InnerDeadZone) / (OuterDeadZone - InnerDeadZone);
+	}
+
+	if (AntiDeadZone > 0.0f)
+	{
+		Magnitude = AntiDeadZone + ((1.0f - AntiDeadZone) * FMath::Min<float>(Magnitude, 1.0f));
+	}
+
+	return Curve.Eval(Magnitude);
+}
+
+
+FVector2D FCursorInputConditioner::Condition(const FVector2D& RawInput, const float DeltaTime)
+{
+	FVector2D Input = bUseJitterFilter ? ApplyJitterFilter(RawInput, DeltaTime) : RawInput;
+
+	if (AxialDeadZone > 0.0f)
+	{
+		const float Scale = 1.0f / (1.0f - AxialDeadZone);
+		Input.X = FMath::Abs(Input.X) <= AxialDeadZone ? 0.0f : FMath::Sign(Input.X) * (FMath::Abs(Input.X) - AxialDeadZone) * Scale;
+		Input.Y = FMath::Abs(Input.Y) <= AxialDeadZone ? 0.0f : FMath::Sign(Input.Y) * (FMath::Abs(Input.Y) - AxialDeadZone) * Scale;
+	}
+
+	const float Magnitude = Input.Size();
+	if (Magnitude <= InnerThreshold)
+		return FVector2D::ZeroVector;
+
+	return (Input / Magnitude) * SampleTable(ResponseTable, Magnitude);
+}
+
+
+FVector2D FCursorInputConditioner::ConditionLegacy(const FVector2D& RawInput) const
+{
+	const float Magnitude = RawInput.Size();
+	if (Magnitude <= InnerDeadZone)
+		return FVector2D::ZeroVector;
+
+	return SampleTable(LegacyTable, Magnitude) * (RawInput / Magnitude);
+}
+
+
+void FCursorInputConditioner::ResetFilter()
+{
+	FilteredValue = FVector2D::ZeroVector;
+	FilteredDerivative = FVector2D::ZeroVector;
+	bFilterPrimed = false;
+}
+
+
+FVector2D FCursorInputConditioner::ApplyJitterFilter(const FVector2D& Input, const float DeltaTime)
+{
+	if (!bFilterPrimed || DeltaTime <= 0.0f)
+	{
+		FilteredValue = Input;
+		FilteredDerivative = FVector2D::ZeroVector;
+		bFilterPrimed = true;
+		return Input;
+	}
+
+	// Smooth the speed of the stick, then let it open up the cutoff of the value filter
+	const FVector2D Derivative = (Input - FilteredValue) / DeltaTime;
+	FilteredDerivative = FMath::Lerp(FilteredDerivative, Derivative, GetLowPassAlpha(FilterDerivativeCutoff, DeltaTime));
+
+	const float Cutoff = FilterMinCutoff + (FilterBeta * FilteredDerivative.Size());
+	FilteredValue = FMath::Lerp(FilteredValue, Input, GetLowPassAlpha(Cutoff, DeltaTime));
+	return FilteredValue;
+}
@@ -0,0 +1,100 @@
+#include "VirtualCursor/CursorKeyBindings.h"
+#include "VirtualCursor/CursorSettings.h"
+#include "VirtualCursorPlugin.h"
+#include "GameFramework/InputSettings.h"
+
+
+uint32 FCursorKeyBindings::InputRevision = 1;
+
+
+void FCursorKeyBindings::Build(const EAnalogStick Stick, const ECursorScrollInput ScrollInput)
+{
+	const UCursorSettings* Settings = GetDefault<UCursorSettings>();
+	Table.Reset();
+
+	// Mapped keys take precedence over the stick and scroll input defaults
+	if (Settings->GetCursorMoveXAxis() != NAME_None || Settings->GetCursorMoveYAxis() != NAME_None)
+	{
+		AddAxis(Settings->GetCursorMoveXAxis(), ECursorInputRole::MoveX);
+		AddAxis(Settings->GetCursorMoveYAxis(), ECursorInputRole::MoveY);
+	}
+	else
+	{
+		Add(Stick == EAnalogStick::Left ? EKeys::Gamepad_LeftX : EKeys::Gamepad_RightX, ECursorInputRole::MoveX, 1.0f);
+		Add(Stick == EAnalogStick::Left ? EKeys::Gamepad_LeftY : EKeys::Gamepad_RightY, ECursorInputRole::MoveY, 1.0f);
+	}
+
+	if (ScrollInput != ECursorScrollInput::None)
+	{
+		if (Settings->GetCursorScrollAxis() != NAME_None)
+		{
+			AddAxis(Settings->GetCursorScrollAxis(), ECursorInputRole::Scroll);
+		}
+		else if (ScrollInput == ECursorScrollInput::OtherStick)
+		{
+			Add(Stick == EAnalogStick::Left ? EKeys::Gamepad_RightY : EKeys::Gamepad_LeftY, ECursorInputRole::Scroll, 1.0f);
+		}
+		else if (ScrollInput == ECursorScrollInput::Triggers)
+		{
+			Add(EKeys::Gamepad_LeftTriggerAxis, ECursorInputRole::Scroll, 1.0f);
+			Add(EKeys::Gamepad_RightTriggerAxis, ECursorInputRole::Scroll, -1.0f);
+		}
+	}
+
+	if (Settings->GetCursorClickAction() != NAME_None)
+	{
+		TArray<FInputActionKeyMapping> Mappings;
+		GetDefault<UInputSettings>()->GetActionMappingByName(Settings->GetCursorClickAction(), Mappings);
+		for (const FInputActionKeyMapping& Mapping : Mappings)
+		{
+			Add(Mapping.Key, ECursorInputRole::Click, 1.0f);
+		}
+	}
+
+	BuiltSettingsRevision = UCursorSettings::GetRevision();
+	BuiltInputRevision = InputRevision;
+	BuiltStick = Stick;
+	BuiltScrollInput = ScrollInput;
+}
+
+
+bool FCursorKeyBindings::IsStale(const EAnalogStick Stick, const ECursorScrollInput ScrollInput) const
+{
+	return BuiltSettingsRevision != UCursorSettings::GetRevision() || BuiltInputRevision != InputRevision || BuiltStick != Stick || BuiltScrollInput != ScrollInput;
+}
+
+
+bool FCursorKeyBindings::Add(const FKey& Key, const ECursorInputRole Role, const float Scale)
+{
+	if (!Key.IsValid() || Table.Num() >= MaxSlots)
+		return false;
+
+	if (const FCursorKeyBinding* Existing = Table.Find(Key))
+	{
+		if (Existing->Role != Role)
+		{
+			UE_LOG(LogVirtualCursor, Warning, TEXT("FCursorKeyBindings -- %s is bound to more than one cursor role, only the first is used."), *Key.ToString());
+		}
+		return false;
+	}
+
+	FCursorKeyBinding& Binding = Table.Add(Key);
+	Binding.Role = Role;
+	Binding.Slot = static_cast<uint8>(Table.Num() - 1);
+	Binding.Scale = Scale;
+	return true;
+}
+
+
+void FCursorKeyBindings::AddAxis(const FName AxisName, const ECursorInputRole Role)
+{
+	if (AxisName == NAME_None)
+		return;
+
+	TArray<FInputAxisKeyMapping> Mappings;
+	GetDefault<UInputSettings>()->GetAxisMappingByName(AxisName, Mappings);
+	for (const FInputAxisKeyMapping& Mapping : Mappings)
+	{
+		Add(Mapping.Key, Role, Mapping.Scale);
+	}
+}
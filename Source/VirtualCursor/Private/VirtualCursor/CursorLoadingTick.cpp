@@ -0,0 +1,116 @@
+#include "VirtualCursor/CursorLoadingTick.h"
+#include "VirtualCursor/CursorStateBuffer.h"
+#include "VirtualCursor/ExtendedAnalogCursor.h"
+#include "VirtualCursorPlugin.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+
+
+/** How often the cursors are stepped while loading, roughly 120Hz */
+static const uint32 StepIntervalMs = 8;
+
+
+FVirtualCursorLoadingTick::~FVirtualCursorLoadingTick()
+{
+	End();
+}
+
+
+void FVirtualCursorLoadingTick::Begin(const TArray<TSharedPtr<FExtendedAnalogCursor>>& InCursors)
+{
+	check(IsInGameThread());
+	if (Thread || InCursors.Num() == 0)
+		return;
+
+	Cursors.Reset();
+	for (const TSharedPtr<FExtendedAnalogCursor>& Cursor : InCursors)
+	{
+		if (Cursor.IsValid() && Cursor->BeginLoadingTick())
+		{
+			Cursors.Add(Cursor);
+		}
+	}
+	if (Cursors.Num() == 0)
+		return;
+
+	bStopping = false;
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool();
+	Thread = FRunnableThread::Create(this, TEXT("VirtualCursorLoadingTick"), 0, TPri_AboveNormal);
+	if (!Thread)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		WakeEvent = nullptr;
+		for (const TSharedPtr<FExtendedAnalogCursor>& Cursor : Cursors)
+		{
+			Cursor->EndLoadingTick();
+		}
+		Cursors.Reset();
+		return;
+	}
+	UE_LOG(LogVirtualCursor, Verbose, TEXT("Loading tick took over %d cursor(s)"), Cursors.Num());
+}
+
+
+void FVirtualCursorLoadingTick::End()
+{
+	check(IsInGameThread());
+	if (!Thread)
+		return;
+
+	// Stop() is called by Kill. Once it returns, nothing else touches the cursors' loading state.
+	Thread->Kill(true);
+	delete Thread;
+	Thread = nullptr;
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+
+	for (const TSharedPtr<FExtendedAnalogCursor>& Cursor : Cursors)
+	{
+		Cursor->EndLoadingTick();
+	}
+	Cursors.Reset();
+}
+
+
+uint32 FVirtualCursorLoadingTick::Run()
+{
+	// Each cursor released its state slot in BeginLoadingTick, and claims it back in EndLoadingTick once this returns
+	FVirtualCursorStateBuffer& StateBuffer = FVirtualCursorStateBuffer::Get();
+	for (const TSharedPtr<FExtendedAnalogCursor>& Cursor : Cursors)
+	{
+		StateBuffer.ClaimWriter(Cursor->GetStateSlot());
+	}
+
+	double LastTime = FPlatformTime::Seconds();
+	while (!bStopping)
+	{
+		WakeEvent->Wait(StepIntervalMs);
+
+		const double Time = FPlatformTime::Seconds();
+		const float DeltaTime = FMath::Min<float>(static_cast<float>(Time - LastTime), 0.1f);
+		LastTime = Time;
+
+		for (const TSharedPtr<FExtendedAnalogCursor>& Cursor : Cursors)
+		{
+			Cursor->TickLoading(Time, DeltaTime);
+		}
+	}
+
+	for (const TSharedPtr<FExtendedAnalogCursor>& Cursor : Cursors)
+	{
+		StateBuffer.ReleaseWriter(Cursor->GetStateSlot());
+	}
+	return 0;
+}
+
+
+void FVirtualCursorLoadingTick::Stop()
+{
+	bStopping = true;
+	if (WakeEvent)
+	{
+		WakeEvent->Trigger();
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Templates/Atomic.h"
+
+class FExtendedAnalogCursor;
+class FRunnableThread;
+class FEvent;
+
+
+/**
+ * Keeps cursors moving while the game thread is blocked on a map load or a loading screen.
+ * Between Begin and End it owns the physics of every cursor it was given and steps them from its own thread,
+ * publishing to FVirtualCursorStateBuffer. The cursors only hand it copies of their state, so it touches no UObject.
+ * Owned by FVirtualCursorPlugin.
+ */
+class FVirtualCursorLoadingTick : public FRunnable
+{
+public:
+
+	virtual ~FVirtualCursorLoadingTick();
+
+	/** Game thread only. Takes over the physics of Cursors and starts the thread. Does nothing if already running. */
+	void Begin(const TArray<TSharedPtr<FExtendedAnalogCursor>>& InCursors);
+
+	/** Game thread only. Stops the thread and hands the cursors their state back. */
+	void End();
+
+	FORCEINLINE bool IsRunning() const
+	{
+		return Thread != nullptr;
+	}
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+
+	TArray<TSharedPtr<FExtendedAnalogCursor>> Cursors;
+
+	FRunnableThread* Thread = nullptr;
+
+	FEvent* WakeEvent = nullptr;
+
+	TAtomic<bool> bStopping { false };
+};
@@ -0,0 +1,99 @@
+#include "VirtualCursor/CursorMagnetismField.h"
+#include "VirtualCursor/CursorGeometry.h"
+
+
+void FCursorMagnetismField::Build(const FSlateRect& ViewportBounds, const TArray<FSlateRect>& InteractableRects, const float Radius, const float CellSize)
+{
+	Cells.Reset();
+	Bounds = ViewportBounds;
+
+	const FVector2D Size = ViewportBounds.GetSize();
+	if (Size.X < 1.0f || Size.Y < 1.0f || Radius <= 0.0f)
+	{
+		Resolution = FIntPoint::ZeroValue;
+		return;
+	}
+
+	Resolution.X = FMath::Clamp(FMath::CeilToInt(Size.X / FMath::Max<float>(CellSize, 1.0f)), 1, MaxResolution);
+	Resolution.Y = FMath::Clamp(FMath::CeilToInt(Size.Y / FMath::Max<float>(CellSize, 1.0f)), 1, MaxResolution);
+	CellsPerPixel = FVector2D(Resolution.X / Size.X, Resolution.Y / Size.Y);
+	const FVector2D CellExtent(1.0f / CellsPerPixel.X, 1.0f / CellsPerPixel.Y);
+
+	Cells.SetNum(Resolution.X * Resolution.Y);
+
+	// Distance to the nearest widget found so far per cell, so each widget only visits the cells it can reach
+	TArray<float> NearestDistance;
+	NearestDistance.Init(Radius, Cells.Num());
+
+	for (const FSlateRect& Rect : InteractableRects)
+	{
+		const FSlateRect Reach = Rect.ExtendBy(FMargin(Radius));
+		if (!FSlateRect::DoRectanglesIntersect(Reach, ViewportBounds))
+			continue;
+
+		const FVector2D Centre = Rect.GetCenter();
+		const float HalfExtent = FMath::Max<float>(Rect.GetSize().GetMax() * 0.5f, 1.0f);
+
+		const int32 MinX = FMath::Clamp(FMath::FloorToInt((Reach.Left - Bounds.Left) * CellsPerPixel.X), 0, Resolution.X - 1);
+		const int32 MaxX = FMath::Clamp(FMath::CeilToInt((Reach.Right - Bounds.Left) * CellsPerPixel.X), 0, Resolution.X - 1);
+		const int32 MinY = FMath::Clamp(FMath::FloorToInt((Reach.Top - Bounds.Top) * CellsPerPixel.Y), 0, Resolution.Y - 1);
+		const int32 MaxY = FMath::Clamp(FMath::CeilToInt((Reach.Bottom - Bounds.Top) * CellsPerPixel.Y), 0, Resolution.Y - 1);
+
+		for (int32 Y = MinY; Y <= MaxY; ++Y)
+		{
+			for (int32 X = MinX; X <= MaxX; ++X)
+			{
+				const int32 Index = (Y * Resolution.X) + X;
+				const FVector2D CellCentre = Bounds.GetTopLeft() + (FVector2D(X + 0.5f, Y + 0.5f) * CellExtent);
+				const float Distance = DistanceToRect(Rect, CellCentre);
+
+				// Over overlapping widgets the later one wins, since it paints on top and is what the hit test reports
+				if (Distance > 0.0f && Distance >= NearestDistance[Index])
+					continue;
+
+				NearestDistance[Index] = Distance;
+
+				FCursorMagnetismSample& Cell = Cells[Index];
+				const FVector2D ToCentre = Centre - CellCentre;
+				if (Distance > 0.0f)
+				{
+					const float Weight = 1.0f - (Distance / Radius);
+					Cell.Pull = ToCentre.GetSafeNormal() * Weight;
+					Cell.Friction = Weight;
+				}
+				else
+				{
+					// Eases off towards the centre so the cursor settles there instead of oscillating around it
+					Cell.Pull = (ToCentre / HalfExtent).GetClampedToMaxSize(1.0f);
+					Cell.Friction = 1.0f;
+				}
+			}
+		}
+	}
+}
+
+
+FCursorMagnetismSample FCursorMagnetismField::Sample(const FVector2D& AbsolutePosition) const
+{
+	FCursorMagnetismSample Result;
+	if (Cells.Num() == 0)
+		return Result;
+
+	const float GridX = FMath::Clamp(((AbsolutePosition.X - Bounds.Left) * CellsPerPixel.X) - 0.5f, 0.0f, Resolution.X - 1.0f);
+	const float GridY = FMath::Clamp(((AbsolutePosition.Y - Bounds.Top) * CellsPerPixel.Y) - 0.5f, 0.0f, Resolution.Y - 1.0f);
+	const int32 X0 = FMath::FloorToInt(GridX);
+	const int32 Y0 = FMath::FloorToInt(GridY);
+	const int32 X1 = FMath::Min(X0 + 1, Resolution.X - 1);
+	const int32 Y1 = FMath::Min(Y0 + 1, Resolution.Y - 1);
+	const float AlphaX = GridX - X0;
+	const float AlphaY = GridY - Y0;
+
+	const FCursorMagnetismSample& A = Cells[(Y0 * Resolution.X) + X0];
+	const FCursorMagnetismSample& B = Cells[(Y0 * Resolution.X) + X1];
+	const FCursorMagnetismSample& C = Cells[(Y1 * Resolution.X) + X0];
+	const FCursorMagnetismSample& D = Cells[(Y1 * Resolution.X) + X1];
+
+	Result.Pull = FMath::Lerp(FMath::Lerp(A.Pull, B.Pull, AlphaX), FMath::Lerp(C.Pull, D.Pull, AlphaX), AlphaY);
+	Result.Friction = FMath::Lerp(FMath::Lerp(A.Friction, B.Friction, AlphaX), FMath::Lerp(C.Friction, D.Friction, AlphaX), AlphaY);
+	return Result;
+}
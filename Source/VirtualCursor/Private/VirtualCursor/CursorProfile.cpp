@@ -0,0 +1,49 @@
+#include "VirtualCursor/CursorProfile.h"
+
+
+TAtomic<uint32> UCursorProfile::RevisionCounter(0);
+
+
+void UCursorProfile::PostInitProperties()
+{
+	Super::PostInitProperties();
+	Invalidate();
+}
+
+
+void UCursorProfile::PostLoad()
+{
+	Super::PostLoad();
+	Invalidate();
+}
+
+
+#if WITH_EDITOR
+void UCursorProfile::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	Invalidate();
+}
+#endif
+
+
+void UCursorProfile::Invalidate()
+{
+	Revision = ++RevisionCounter;
+}
+
+
+const FCompiledCursorProfile& UCursorProfile::GetCompiled() const
+{
+	check(IsInGameThread());
+	const uint32 CurrentRevision = Revision.Load();
+	if (Compiled.Revision == CurrentRevision)
+		return Compiled;
+
+	FCursorConditioningParams Params;
+	Tuning.Compile(Compiled.Tuning, Params);
+	Compiled.Conditioner.Compile(Params, CurrentRevision);
+
+	Compiled.Revision = CurrentRevision;
+	return Compiled;
+}
@@ -0,0 +1,62 @@
+#include "VirtualCursor/CursorSettings.h"
+#include "Misc/ConfigCacheIni.h"
+#include "UObject/UnrealType.h"
+
+
+TAtomic<uint32> UCursorSettings::Revision(1);
+
+
+void UCursorSettings::PostInitProperties()
+{
+	Super::PostInitProperties();
+	if (HasAnyFlags(RF_ClassDefaultObject))
+	{
+		LoadLegacyTuning();
+	}
+	++Revision;
+}
+
+
+void UCursorSettings::LoadLegacyTuning()
+{
+	const FString Section = GetClass()->GetPathName();
+	FString Value;
+	if (GConfig->GetString(*Section, TEXT("Tuning"), Value, GGameIni))
+		return;
+
+	// The struct kept the names the properties had on the settings, so each old key still names its field
+	for (TFieldIterator<FProperty> It(FCursorTuningSettings::StaticStruct()); It; ++It)
+	{
+		if (GConfig->GetString(*Section, *It->GetName(), Value, GGameIni))
+		{
+			It->ImportText(*Value, It->ContainerPtrToValuePtr<void>(&Tuning), PPF_None, this);
+		}
+	}
+}
+
+
+UMaterialParameterCollection* UCursorSettings::LoadCursorParameterCollection()
+{
+	check(IsInGameThread());
+	if (!LoadedCursorParameterCollection && !CursorParameterCollection.IsNull())
+	{
+		LoadedCursorParameterCollection = CursorParameterCollection.LoadSynchronous();
+	}
+	return LoadedCursorParameterCollection;
+}
+
+
+#if WITH_EDITOR
+void UCursorSettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	++Revision;
+
+	// Cursors that already exist switch to the new collection on their next publish
+	if (PropertyChangedEvent.GetPropertyName() == GET_MEMBER_NAME_CHECKED(UCursorSettings, CursorParameterCollection))
+	{
+		LoadedCursorParameterCollection = nullptr;
+		LoadCursorParameterCollection();
+	}
+}
+#endif
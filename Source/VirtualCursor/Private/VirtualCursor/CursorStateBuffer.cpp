@@ -0,0 +1,148 @@
+#include "VirtualCursor/CursorStateBuffer.h"
+#include "HAL/PlatformMisc.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTLS.h"
+
+
+/** How many times a reader retries before giving up on a slot that is being written */
+static const int32 MaxReadAttempts = 4;
+
+
+FVirtualCursorStateBuffer& FVirtualCursorStateBuffer::Get()
+{
+	static FVirtualCursorStateBuffer Instance;
+	return Instance;
+}
+
+
+int32 FVirtualCursorStateBuffer::AcquireSlot()
+{
+	check(IsInGameThread());
+	for (int32 Slot = 0; Slot < MaxCursors; ++Slot)
+	{
+		if (!Slots[Slot].bTaken)
+		{
+			Slots[Slot].bTaken = true;
+			Slots[Slot].WriterThreadId = FPlatformTLS::GetCurrentThreadId();
+			return Slot;
+		}
+	}
+	return INDEX_NONE;
+}
+
+
+void FVirtualCursorStateBuffer::ReleaseSlot(const int32 Slot)
+{
+	check(IsInGameThread());
+	if (Slot < 0 || Slot >= MaxCursors)
+		return;
+
+	Retire(Slot);
+	Slots[Slot].bTaken = false;
+	Slots[Slot].WriterThreadId = 0;
+}
+
+
+void FVirtualCursorStateBuffer::ClaimWriter(const int32 Slot)
+{
+	if (Slot < 0 || Slot >= MaxCursors)
+		return;
+
+	const uint32 PreviousWriter = Slots[Slot].WriterThreadId.Exchange(FPlatformTLS::GetCurrentThreadId());
+	checkf(PreviousWriter == 0, TEXT("Cursor state slot %d claimed while thread %u still writes it"), Slot, PreviousWriter);
+}
+
+
+void FVirtualCursorStateBuffer::ReleaseWriter(const int32 Slot)
+{
+	if (Slot < 0 || Slot >= MaxCursors)
+		return;
+
+	const uint32 PreviousWriter = Slots[Slot].WriterThreadId.Exchange(0);
+	checkf(PreviousWriter == FPlatformTLS::GetCurrentThreadId(), TEXT("Cursor state slot %d released by a thread that does not write it"), Slot);
+}
+
+
+void FVirtualCursorStateBuffer::Publish(const int32 Slot, const FVirtualCursorSnapshot& Snapshot)
+{
+	Write(Slot, Snapshot);
+}
+
+
+void FVirtualCursorStateBuffer::Retire(const int32 Slot)
+{
+	if (Slot < 0 || Slot >= MaxCursors)
+		return;
+
+	FVirtualCursorSnapshot Retired = Slots[Slot].Data;
+	Retired.bActive = false;
+	Retired.Velocity = FVector2D::ZeroVector;
+	Write(Slot, Retired);
+}
+
+
+void FVirtualCursorStateBuffer::Write(const int32 SlotIndex, const FVirtualCursorSnapshot& Snapshot)
+{
+	if (SlotIndex < 0 || SlotIndex >= MaxCursors)
+		return;
+
+	FSlot& Slot = Slots[SlotIndex];
+	checkf(Slot.WriterThreadId.Load(EMemoryOrder::Relaxed) == FPlatformTLS::GetCurrentThreadId(), TEXT("Cursor state slot %d written by a thread that does not own it"), SlotIndex);
+
+	// Single writer, so a plain increment is enough to make the sequence odd
+	Slot.Sequence.Store(Slot.Sequence.Load(EMemoryOrder::Relaxed) + 1);
+	FPlatformMisc::MemoryBarrier();
+
+	Slot.Data = Snapshot;
+	Slot.Data.StateSlot = SlotIndex;
+
+	FPlatformMisc::MemoryBarrier();
+	Slot.Sequence.Store(Slot.Sequence.Load(EMemoryOrder::Relaxed) + 1);
+}
+
+
+bool FVirtualCursorStateBuffer::Read(const int32 SlotIndex, FVirtualCursorSnapshot& OutSnapshot) const
+{
+	if (SlotIndex < 0 || SlotIndex >= MaxCursors)
+		return false;
+
+	const FSlot& Slot = Slots[SlotIndex];
+	for (int32 Attempt = 0; Attempt < MaxReadAttempts; ++Attempt)
+	{
+		const uint32 Before = Slot.Sequence.Load();
+		if (Before == 0)
+		{
+			// Never published
+			return false;
+		}
+		if (Before & 1)
+		{
+			FPlatformProcess::YieldThread();
+			continue;
+		}
+
+		FPlatformMisc::MemoryBarrier();
+		OutSnapshot = Slot.Data;
+		FPlatformMisc::MemoryBarrier();
+
+		if (Slot.Sequence.Load() == Before)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+
+int32 FVirtualCursorStateBuffer::ReadAll(FVirtualCursorSnapshot (&OutSnapshots)[MaxCursors]) const
+{
+	int32 Count = 0;
+	for (int32 Slot = 0; Slot < MaxCursors; ++Slot)
+	{
+		if (Read(Slot, OutSnapshots[Count]) && OutSnapshots[Count].bActive)
+		{
+			++Count;
+		}
+	}
+	return Count;
+}
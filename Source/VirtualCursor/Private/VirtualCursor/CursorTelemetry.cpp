@@ -0,0 +1,139 @@
+#include "VirtualCursor/CursorTelemetry.h"
+#include "VirtualCursorPlugin.h"
+#include "HAL/Event.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+
+/** How often the writer wakes up to drain the ring */
+static const uint32 DrainIntervalMs = 20;
+
+
+FVirtualCursorTelemetry* FVirtualCursorTelemetry::ActiveSession = nullptr;
+
+
+bool FVirtualCursorTelemetry::Begin(const FString& InFilename, const int32 Capacity)
+{
+	check(IsInGameThread());
+	End();
+
+	const FString Filename = !InFilename.IsEmpty() ? InFilename 
+		: FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("VirtualCursor"), FString::Printf(TEXT("CursorTelemetry_%s.csv"), *FDateTime::Now().ToString()));
+
+	FArchive* Writer = IFileManager::Get().CreateFileWriter(*Filename);
+	if (!Writer)
+	{
+		UE_LOG(LogVirtualCursor, Warning, TEXT("FVirtualCursorTelemetry::Begin -- Could not open %s for writing."), *Filename);
+		return false;
+	}
+
+	ActiveSession = new FVirtualCursorTelemetry(Filename, Writer, FMath::Max<int32>(Capacity, 64));
+	UE_LOG(LogVirtualCursor, Log, TEXT("Cursor telemetry recording to %s"), *Filename);
+	return true;
+}
+
+
+void FVirtualCursorTelemetry::End()
+{
+	check(IsInGameThread());
+	if (ActiveSession)
+	{
+		FVirtualCursorTelemetry* Session = ActiveSession;
+		ActiveSession = nullptr;
+
+		UE_LOG(LogVirtualCursor, Log, TEXT("Cursor telemetry stopped: %llu records written, %llu dropped"), Session->GetWrittenCount(), Session->GetDroppedCount());
+		delete Session;
+	}
+}
+
+
+FVirtualCursorTelemetry::FVirtualCursorTelemetry(const FString& InFilename, FArchive* InWriter, const int32 Capacity)
+	: Filename(InFilename)
+	, Writer(InWriter)
+	, Queue(Capacity)
+	, WakeEvent(FPlatformProcess::GetSynchEventFromPool())
+	, Thread(nullptr)
+{
+	static const ANSICHAR Header[] = "Frame,Time,User,X,Y,VelocityX,VelocityY,Analog,Hovered,TickMicroseconds\n";
+	Writer->Serialize(const_cast<ANSICHAR*>(Header), sizeof(Header) - 1);
+
+	Thread = FRunnableThread::Create(this, TEXT("VirtualCursorTelemetry"), 0, TPri_BelowNormal);
+}
+
+
+FVirtualCursorTelemetry::~FVirtualCursorTelemetry()
+{
+	if (Thread)
+	{
+		// Stop() is called by Kill and wakes the writer for its final drain
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+
+	if (Writer)
+	{
+		Writer->Close();
+		delete Writer;
+		Writer = nullptr;
+	}
+}
+
+
+uint32 FVirtualCursorTelemetry::Run()
+{
+	while (!bStopping)
+	{
+		WakeEvent->Wait(DrainIntervalMs);
+		Drain();
+	}
+
+	// Whatever the game thread pushed before stopping
+	Drain();
+	Writer->Flush();
+	return 0;
+}
+
+
+void FVirtualCursorTelemetry::Stop()
+{
+	bStopping = true;
+	WakeEvent->Trigger();
+}
+
+
+void FVirtualCursorTelemetry::Drain()
+{
+	LineBuffer.Reset();
+
+	FCursorTelemetryRecord Record;
+	uint64 Drained = 0;
+	while (Queue.Dequeue(Record))
+	{
+		const FString Line = FString::Printf(TEXT("%llu,%.6f,%d,%.2f,%.2f,%.2f,%.2f,%d,%s,%.2f\n"),
+			Record.FrameNumber,
+			Record.Time,
+			Record.UserIndex,
+			Record.Position.X, Record.Position.Y,
+			Record.Velocity.X, Record.Velocity.Y,
+			Record.bIsUsingAnalogCursor ? 1 : 0,
+			*Record.HoveredWidget.ToString(),
+			FPlatformTime::ToMilliseconds(Record.TickCycles) * 1000.0f);
+
+		const FTCHARToUTF8 Converted(*Line);
+		LineBuffer.Append(Converted.Get(), Converted.Length());
+		++Drained;
+	}
+
+	if (LineBuffer.Num() > 0)
+	{
+		Writer->Serialize(LineBuffer.GetData(), LineBuffer.Num());
+		WrittenRecords += Drained;
+	}
+}
@@ -0,0 +1,49 @@
+#include "VirtualCursor/CursorTuning.h"
+#include "VirtualCursor/CursorInputConditioner.h"
+
+
+FCursorTuning FCursorTuning::GetScaled(const float DPIScale) const
+{
+	FCursorTuning Scaled = *this;
+	Scaled.MaxSpeed *= DPIScale;
+	Scaled.MaxSpeedHovered *= DPIScale;
+	Scaled.DragCo *= DPIScale;
+	Scaled.DragCoHovered *= DPIScale;
+	Scaled.MinSpeed *= DPIScale;
+	Scaled.AccelerationScale *= DPIScale * DPIScale;
+	Scaled.CursorRadius *= DPIScale;
+	Scaled.MagnetismRadius *= DPIScale;
+	return Scaled;
+}
+
+
+void FCursorTuningSettings::Compile(FCursorTuning& OutTuning, FCursorConditioningParams& OutParams) const
+{
+	// The hovered drag is never lower than the normal one, whichever way round they were authored
+	OutTuning.MaxSpeed = MaxAnalogCursorSpeed;
+	OutTuning.MaxSpeedHovered = MaxAnalogCursorSpeedWhenHovered;
+	OutTuning.DragCo = FMath::Min<float>(AnalogCursorDragCoefficientWhenHovered, AnalogCursorDragCoefficient);
+	OutTuning.DragCoHovered = FMath::Max<float>(AnalogCursorDragCoefficientWhenHovered, AnalogCursorDragCoefficient);
+	OutTuning.MinSpeed = MinAnalogCursorSpeed;
+	OutTuning.AccelerationScale = AnalogCursorAccelerationMultiplier;
+	OutTuning.CursorRadius = GetCursorRadius();
+	OutTuning.bNoAcceleration = bAnalogCursorNoAcceleration;
+	OutTuning.MagnetismRadius = MagnetismRadius;
+	OutTuning.MagnetismStrength = MagnetismStrength;
+	OutTuning.MagnetismFriction = MagnetismFriction;
+	OutTuning.ScrollSpeed = AnalogScrollSpeed;
+	OutTuning.ScrollDeadZone = FMath::Min<float>(AnalogScrollDeadZone, 0.99f);
+	OutTuning.ScrollStep = FMath::Max<float>(AnalogScrollStep, 0.01f);
+
+	OutParams.Curve = AnalogCursorAccelerationCurve.GetRichCurveConst();
+	OutParams.InnerDeadZone = AnalogCursorDeadZone;
+	OutParams.OuterDeadZone = FMath::Max<float>(AnalogCursorOuterDeadZone, AnalogCursorDeadZone + KINDA_SMALL_NUMBER);
+	OutParams.AntiDeadZone = AnalogCursorAntiDeadZone;
+	OutParams.bScaledRadial = AnalogCursorDeadZoneType == ECursorDeadZoneType::ScaledRadial;
+	OutParams.AxialDeadZone = AnalogCursorAxialDeadZone;
+
+	OutParams.bUseJitterFilter = bUseJitterFilter;
+	OutParams.FilterMinCutoff = FMath::Max<float>(JitterFilterMinCutoff, KINDA_SMALL_NUMBER);
+	OutParams.FilterBeta = JitterFilterBeta;
+	OutParams.FilterDerivativeCutoff = FMath::Max<float>(JitterFilterDerivativeCutoff, KINDA_SMALL_NUMBER);
+}
@@ -1,12 +1,23 @@
 #include "VirtualCursor/ExtendedAnalogCursor.h"
 #include "VirtualCursor/CursorSettings.h"
+#include "VirtualCursor/CursorFrameBudget.h"
+#include "VirtualCursor/CursorStateBuffer.h"
+#include "VirtualCursor/CursorTelemetry.h"
+#include "VirtualCursor/VirtualCursorTicker.h"
+#include "VirtualCursorPlugin.h"
 #include "Blueprint/SlateBlueprintLibrary.h"
+#include "Blueprint/UserWidget.h"
 #include "Blueprint/WidgetLayoutLibrary.h"
+#include "Components/WidgetInteractionComponent.h"
 #include "Engine/UserInterfaceSettings.h"
 #include "Engine/Engine.h"
+#include "Engine/GameViewportClient.h"
 #include "Framework/Application/SlateUser.h"
 #include "GameMapsSettings.h"
+#include "HAL/IConsoleManager.h"
+#include "Materials/MaterialParameterCollectionInstance.h"
 #include "Slate/SGameLayerManager.h"
+#include "Slate/SObjectWidget.h"
 #include "Widgets/SViewport.h"
 
 
@@ -16,6 +27,35 @@ bool IsWidgetInteractable(const TSharedPtr<SWidget> Widget)
 }
 
 
+static TAutoConsoleVariable<int32> CVarValidateParallelHover(
+	TEXT("VirtualCursor.ValidateParallelHover"),
+	0,
+	TEXT("If 1, hover results resolved in parallel are checked against the serial hittest and mismatches are logged."),
+	ECVF_Cheat);
+
+
+/** HoveredWidgetName used while the cursor is over an interactable world-space widget */
+static const FName WorldWidgetHoverName(TEXT("WidgetComponent"));
+
+
+/** Returns the class name of the outermost user widget in the path, NAME_None if there is none */
+static FName FindLayoutName(const FWidgetPath& WidgetPath)
+{
+	static const FName ObjectWidgetType(TEXT("SObjectWidget"));
+
+	for (int32 i = 0; i < WidgetPath.Widgets.Num(); ++i)
+	{
+		const TSharedRef<SWidget>& Widget = WidgetPath.Widgets[i].Widget;
+		if (Widget->GetType() == ObjectWidgetType)
+		{
+			UUserWidget* UserWidget = StaticCastSharedRef<SObjectWidget>(Widget)->GetWidgetObject();
+			return UserWidget ? UserWidget->GetClass()->GetFName() : NAME_None;
+		}
+	}
+	return NAME_None;
+}
+
+
 FExtendedAnalogCursor::FExtendedAnalogCursor(ULocalPlayer* InLocalPlayer, UWorld* InWorld, float _Radius)
 	: bDebugging(false)
 	, bAnalogDebug(false)
@@ -29,8 +69,13 @@ FExtendedAnalogCursor::FExtendedAnalogCursor(ULocalPlayer* InLocalPlayer, UWorld
 {
 	ensure(PlayerContext.IsValid());
 
-	const UCursorSettings* settings = GetMutableDefault<UCursorSettings>();
+	UCursorSettings* settings = GetMutableDefault<UCursorSettings>();
 	bClampToViewport = settings->GetDefaultClampToViewport();
+	settings->LoadCursorParameterCollection();
+	ApplyTuning(nullptr);
+	SetInputConsumption(ECursorInputMode::UIOnly, settings->GetInputConsumption(ECursorInputMode::UIOnly));
+	SetInputConsumption(ECursorInputMode::GameAndUI, settings->GetInputConsumption(ECursorInputMode::GameAndUI));
+	StateSlot = FVirtualCursorStateBuffer::Get().AcquireSlot();
 }
 
 
@@ -47,8 +92,19 @@ FExtendedAnalogCursor::FExtendedAnalogCursor(class APlayerController* PlayerCont
 {
 	ensure(PlayerContext.IsValid());
 
-	const UCursorSettings* settings = GetMutableDefault<UCursorSettings>();
+	UCursorSettings* settings = GetMutableDefault<UCursorSettings>();
 	bClampToViewport = settings->GetDefaultClampToViewport();
+	settings->LoadCursorParameterCollection();
+	ApplyTuning(nullptr);
+	SetInputConsumption(ECursorInputMode::UIOnly, settings->GetInputConsumption(ECursorInputMode::UIOnly));
+	SetInputConsumption(ECursorInputMode::GameAndUI, settings->GetInputConsumption(ECursorInputMode::GameAndUI));
+	StateSlot = FVirtualCursorStateBuffer::Get().AcquireSlot();
+}
+
+
+FExtendedAnalogCursor::~FExtendedAnalogCursor()
+{
+	FVirtualCursorStateBuffer::Get().ReleaseSlot(StateSlot);
 }
 
 
@@ -88,25 +144,72 @@ bool FExtendedAnalogCursor::HandleKeyDownEvent(FSlateApplication& SlateApp, cons
 		return false;
 	}
 
+	// Bound keys move or scroll the cursor instead of reaching the game, bound click keys act as Accept
+	if (const FCursorKeyBinding* Binding = FindBinding(newInKeyEvent.GetKey()))
+	{
+		if (Binding->Role != ECursorInputRole::Click)
+		{
+			if (!newInKeyEvent.GetKey().IsFloatAxis() && !newInKeyEvent.IsRepeat())
+			{
+				RecordDebugInput(bDebugging, newInKeyEvent.GetKey(), ECursorDebugInput::Pressed);
+				SetBindingValue(*Binding, 1.0f);
+			}
+			return ConsumeInput(Binding->Role);
+		}
+
+		newInKeyEvent = FKeyEvent(EKeys::Virtual_Accept, newInKeyEvent.GetModifierKeys(), newInKeyEvent.GetUserIndex(), newInKeyEvent.IsRepeat(), 0, 0);
+	}
+
 	const FKey& PressedKey = newInKeyEvent.GetKey();
 
-	if (newInKeyEvent.IsRepeat())
+	// Hover is not resolved during a load, but a loading screen that pumps input can still be clicked, e.g. to skip its movie.
+	// Slate hit tests the click itself.
+	if (bLoadingTickActive && SlateApp.GetNavigationActionFromKey(newInKeyEvent) == EUINavigationAction::Accept)
 	{
-		if (bDebugging)
+		if (!newInKeyEvent.IsRepeat())
 		{
-			GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Green, "KEY: " + PressedKey.ToString() + " Held");
+			PressedKeys.Add(PressedKey);
+			RecordDebugInput(bDebugging, PressedKey, ECursorDebugInput::Pressed);
 		}
+		MoveSlateCursorToLoadingPosition(SlateApp, newInKeyEvent);
+		return ConsumeKeyEvent(SlateApp, newInKeyEvent, FAnalogCursor::HandleKeyDownEvent(SlateApp, newInKeyEvent));
+	}
+
+	// Clicks over a world-space widget go to the widget interaction pointer instead of the viewport
+	if (!newInKeyEvent.IsRepeat() && WorldWidgetInteraction.IsValid() && WorldWidgetInteraction->IsOverInteractableWidget() 
+		&& SlateApp.GetNavigationActionFromKey(newInKeyEvent) == EUINavigationAction::Accept)
+	{
+		PressedKeys.Add(PressedKey);
+		bWorldWidgetPressed = true;
+		WorldWidgetInteraction->PressPointerKey(EKeys::LeftMouseButton);
+		return ConsumeInput(ECursorInputRole::Click);
+	}
+
+	if (newInKeyEvent.IsRepeat())
+	{
+		RecordDebugInput(bDebugging, PressedKey, ECursorDebugInput::Held);
 	}
 	else
 	{
 		PressedKeys.Add(PressedKey);
-		if (bDebugging)
+		RecordDebugInput(bDebugging, PressedKey, ECursorDebugInput::Pressed);
+
+		// Attribute the simulated click to where the cursor was when the player saw it
+		FVector2D ClickPosition;
+		TSharedPtr<FSlateUser> SlateUser = SlateApp.GetUser(newInKeyEvent);
+		if (SlateUser.IsValid() && SlateApp.GetNavigationActionFromKey(newInKeyEvent) == EUINavigationAction::Accept && ResolveClickPosition(FPlatformTime::Seconds(), ClickPosition))
 		{
-			GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Red, "KEY: " + PressedKey.ToString() + " Pressed");
+			const FVector2D ShownPosition = SlateUser->GetCursorPosition();
+			SlateUser->SetCursorPosition(ClickPosition);
+			const bool bHandled = FAnalogCursor::HandleKeyDownEvent(SlateApp, newInKeyEvent);
+			SlateUser->SetCursorPosition(ShownPosition);
+
+			RedirectedClickPosition = ClickPosition;
+			return ConsumeKeyEvent(SlateApp, newInKeyEvent, bHandled);
 		}
 	}
 
-	return FAnalogCursor::HandleKeyDownEvent(SlateApp, newInKeyEvent);
+	return ConsumeKeyEvent(SlateApp, newInKeyEvent, FAnalogCursor::HandleKeyDownEvent(SlateApp, newInKeyEvent));
 }
 
 
@@ -136,15 +239,58 @@ bool FExtendedAnalogCursor::HandleKeyUpEvent(FSlateApplication& SlateApp, const
 		return false;
 	}
 
+	if (const FCursorKeyBinding* Binding = FindBinding(newInKeyEvent.GetKey()))
+	{
+		if (Binding->Role != ECursorInputRole::Click)
+		{
+			if (!newInKeyEvent.GetKey().IsFloatAxis())
+			{
+				RecordDebugInput(bDebugging, newInKeyEvent.GetKey(), ECursorDebugInput::Released);
+				SetBindingValue(*Binding, 0.0f);
+			}
+			return ConsumeInput(Binding->Role);
+		}
+
+		newInKeyEvent = FKeyEvent(EKeys::Virtual_Accept, newInKeyEvent.GetModifierKeys(), newInKeyEvent.GetUserIndex(), newInKeyEvent.IsRepeat(), 0, 0);
+	}
+
 	const FKey& ReleasedKey = newInKeyEvent.GetKey();
 
+	if (bWorldWidgetPressed && SlateApp.GetNavigationActionFromKey(newInKeyEvent) == EUINavigationAction::Accept)
+	{
+		PressedKeys.Remove(ReleasedKey);
+		bWorldWidgetPressed = false;
+		if (WorldWidgetInteraction.IsValid())
+		{
+			WorldWidgetInteraction->ReleasePointerKey(EKeys::LeftMouseButton);
+		}
+		return ConsumeInput(ECursorInputRole::Click);
+	}
+
 	PressedKeys.Remove(ReleasedKey);
-	if (bDebugging)
+	RecordDebugInput(bDebugging, ReleasedKey, ECursorDebugInput::Released);
+
+	if (bLoadingTickActive && SlateApp.GetNavigationActionFromKey(newInKeyEvent) == EUINavigationAction::Accept)
+	{
+		RedirectedClickPosition.Reset();
+		MoveSlateCursorToLoadingPosition(SlateApp, newInKeyEvent);
+		return ConsumeKeyEvent(SlateApp, newInKeyEvent, FAnalogCursor::HandleKeyUpEvent(SlateApp, newInKeyEvent));
+	}
+
+	// Release a redirected click where it was pressed, otherwise the button under it won't see a click
+	TSharedPtr<FSlateUser> SlateUser = SlateApp.GetUser(newInKeyEvent);
+	if (RedirectedClickPosition.IsSet() && SlateUser.IsValid() && SlateApp.GetNavigationActionFromKey(newInKeyEvent) == EUINavigationAction::Accept)
 	{
-		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Cyan, "KEY: " + ReleasedKey.ToString() + " Released");
+		const FVector2D ShownPosition = SlateUser->GetCursorPosition();
+		SlateUser->SetCursorPosition(RedirectedClickPosition.GetValue());
+		const bool bHandled = FAnalogCursor::HandleKeyUpEvent(SlateApp, newInKeyEvent);
+		SlateUser->SetCursorPosition(ShownPosition);
+
+		RedirectedClickPosition.Reset();
+		return ConsumeKeyEvent(SlateApp, newInKeyEvent, bHandled);
 	}
 
-	return FAnalogCursor::HandleKeyUpEvent(SlateApp, newInKeyEvent);
+	return ConsumeKeyEvent(SlateApp, newInKeyEvent, FAnalogCursor::HandleKeyUpEvent(SlateApp, newInKeyEvent));
 }
 
 
@@ -175,17 +321,78 @@ bool FExtendedAnalogCursor::HandleAnalogInputEvent(FSlateApplication& SlateApp,
 		return false;
 	}
 
-	// Prevent Slate from swallowing events that aren't relevant to our virtual cursor
-	if (!IsCursorStickInput(newInAnalogInputEvent))
+	// FAnalogCursor keeps tracking the raw stick values for GetAnalogValues whatever is bound. Its return value would consume
+	// every stick axis, including the one the game reads, so only the bindings and the consumption policy decide that.
+	FAnalogCursor::HandleAnalogInputEvent(SlateApp, newInAnalogInputEvent);
+
+	const FCursorKeyBinding* Binding = FindBinding(newInAnalogInputEvent.GetKey());
+	if (!Binding)
+	{
+		return newInAnalogInputEvent.GetKey().IsGamepadKey() && ConsumeInput(ECursorInputRole::None);
+	}
+
+	// Click bindings act on key events, so the analog half of a bound trigger goes on to Slate untouched
+	if (Binding->Role == ECursorInputRole::Click)
 	{
 		return false;
 	}
 
-	if (bAnalogDebug)
+	RecordDebugInput(bAnalogDebug, newInAnalogInputEvent.GetKey(), ECursorDebugInput::Analog, newInAnalogInputEvent.GetAnalogValue());
+	SetBindingValue(*Binding, newInAnalogInputEvent.GetAnalogValue());
+
+	if (bLoadingTickActive)
 	{
-		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Red, "ANALOG: " + newInAnalogInputEvent.GetKey().ToString());
+		// Slate still delivers input if something pumps it during the load, e.g. a loading screen waiting on its movie
+		FScopeLock Lock(&LoadingStateLock);
+		LoadingState.Stick = GetMoveInput();
+		LoadingState.StickTime = FPlatformTime::Seconds();
 	}
-	return FAnalogCursor::HandleAnalogInputEvent(SlateApp, newInAnalogInputEvent);
+	return ConsumeInput(Binding->Role);
+}
+
+
+void FExtendedAnalogCursor::SetInputConsumption(const ECursorInputMode Mode, const FCursorInputConsumption& Consumption)
+{
+	bool* Row = ConsumptionTable[static_cast<uint8>(Mode)];
+	Row[static_cast<uint8>(ECursorInputRole::None)] = Consumption.bConsumeOtherGamepadKeys;
+	Row[static_cast<uint8>(ECursorInputRole::MoveX)] = Consumption.bConsumeMovement;
+	Row[static_cast<uint8>(ECursorInputRole::MoveY)] = Consumption.bConsumeMovement;
+	Row[static_cast<uint8>(ECursorInputRole::Scroll)] = Consumption.bConsumeScroll;
+	Row[static_cast<uint8>(ECursorInputRole::Click)] = Consumption.bConsumeClick;
+}
+
+
+ECursorInputMode FExtendedAnalogCursor::GetInputMode() const
+{
+	ULocalPlayer* LocalPlayer = PlayerContext.GetLocalPlayer();
+	if (LocalPlayer && IsValid(LocalPlayer->ViewportClient) && LocalPlayer->ViewportClient->IgnoreInput())
+	{
+		return ECursorInputMode::UIOnly;
+	}
+	return ECursorInputMode::GameAndUI;
+}
+
+
+bool FExtendedAnalogCursor::ConsumeInput(const ECursorInputRole Role)
+{
+	if (!ConsumptionTable[static_cast<uint8>(GetInputMode())][static_cast<uint8>(Role)])
+		return false;
+
+	++AbsorbedEventCounts[static_cast<uint8>(Role)];
+	return true;
+}
+
+
+bool FExtendedAnalogCursor::ConsumeKeyEvent(FSlateApplication& SlateApp, const FKeyEvent& KeyEvent, const bool bHandledAsClick)
+{
+	if (bHandledAsClick)
+		return ConsumeInput(ECursorInputRole::Click);
+
+	// Unhandled Accept keys, such as repeats, are left to Slate as they always were
+	if (!KeyEvent.GetKey().IsGamepadKey() || SlateApp.GetNavigationActionFromKey(KeyEvent) == EUINavigationAction::Accept)
+		return false;
+
+	return ConsumeInput(ECursorInputRole::None);
 }
 
 
@@ -222,18 +429,12 @@ bool FExtendedAnalogCursor::HandleMouseButtonDownEvent(FSlateApplication& SlateA
 	const FKey& PressedKey = newMouseEvent.GetEffectingButton();
 	if (PressedKeys.Contains(PressedKey))
 	{
-		if (bDebugging)
-		{
-			GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Green, "MOUSE: " + PressedKey.ToString() + " Held");
-		}
+		RecordDebugInput(bDebugging, PressedKey, ECursorDebugInput::Held);
 	}
 	else
 	{
 		PressedKeys.Add(PressedKey);
-		if (bDebugging)
-		{
-			GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Red, "MOUSE: " + PressedKey.ToString() + " Pressed");
-		}
+		RecordDebugInput(bDebugging, PressedKey, ECursorDebugInput::Pressed);
 	}
 	return false;
 }
@@ -270,10 +471,7 @@ bool FExtendedAnalogCursor::HandleMouseButtonUpEvent(FSlateApplication& SlateApp
 	}
 
 	const FKey& ReleasedKey = newMouseEvent.GetEffectingButton();
-	if (bDebugging)
-	{
-		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Cyan, "MOUSE: " + ReleasedKey.ToString() + " Released");
-	}
+	RecordDebugInput(bDebugging, ReleasedKey, ECursorDebugInput::Released);
 	PressedKeys.Remove(ReleasedKey);
 	return false;
 }
@@ -281,13 +479,25 @@ bool FExtendedAnalogCursor::HandleMouseButtonUpEvent(FSlateApplication& SlateApp
 
 void FExtendedAnalogCursor::Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor)
 {
+	// The loading thread owns the physics until EndLoadingTick
+	if (bLoadingTickActive)
+		return;
+
+	const uint32 TickStartCycles = FPlatformTime::Cycles();
+
 	TSharedPtr<FSlateUser> slateUser = SlateApp.GetUser(GetOwnerUserIndex());
 	if (PlayerContext.IsValid() && PlayerContext.GetPlayerController() && slateUser.IsValid())
 	{
-		const FVector2D ViewportSize = UWidgetLayoutLibrary::GetViewportSize(PlayerContext.GetPlayerController());
-		const float DPIScale = GetDefault<UUserInterfaceSettings>()->GetDPIScaleBasedOnSize(FIntPoint(FMath::RoundToInt(ViewportSize.X), FMath::RoundToInt(ViewportSize.Y)));
+		// Recompile if the profile or settings were edited, rescale if the viewport changed
+		RefreshTuning();
+		RefreshScaledTuning();
 
-		const UCursorSettings* Settings = GetDefault<UCursorSettings>();
+		// Continue from where the loading thread left the cursor instead of treating the difference as mouse movement
+		if (bPendingLoadingHandBack)
+		{
+			bPendingLoadingHandBack = false;
+			UpdateCursorPosition(SlateApp, slateUser.ToSharedRef(), CurrentPosition);
+		}
 
 		// Set the current position if we haven't already
 		static const float MouseMoveSizeBuffer = 2.0f;
@@ -298,81 +508,76 @@ void FExtendedAnalogCursor::Tick(const float DeltaTime, FSlateApplication& Slate
 			Velocity = FVector2D::ZeroVector;
 			LastCursorDirection = FVector2D::ZeroVector;
 			bIsUsingAnalogCursor = false;
-			FSlateApplication::Get().SetCursorRadius(0.0f);
+			InputConditioner.ResetFilter();
+			RequestCursorRadius(0.0f);
 		}
 
 		// Cache the old position
 		const FVector2D OldPosition = CurrentPosition;
 
 		// Figure out if we should clamp the speed or not
-		const float MaxSpeedNoHover = Settings->GetMaxAnalogCursorSpeed() * DPIScale;
-		const float MaxSpeedHover = Settings->GetMaxAnalogCursorSpeedWhenHovered() * DPIScale;
-		const float DragCoNoHover = Settings->GetAnalogCursorDragCoefficient() * DPIScale;
-		const float DragCoHovered = Settings->GetAnalogCursorDragCoefficientWhenHovered() * DPIScale;
-		const float MinCursorSpeed = Settings->GetMinAnalogCursorSpeed() * DPIScale;
-
-		HoveredWidgetName = NAME_None;
-		float DragCo = DragCoNoHover;
+		float DragCo = ScaledTuning.DragCo;
 
 		// Part of base class now
-		MaxSpeed = MaxSpeedNoHover;
+		MaxSpeed = ScaledTuning.MaxSpeed;
+
+		// With magnetism on, its friction is what slows the cursor over widgets, so the hovered values would only slow it twice
+		const bool bUseHoveredTuning = !MagnetismField.IsValid();
 
-		// See if we are hovered over a widget or not
-		FWidgetPath WidgetPath = SlateApp.LocateWindowUnderMouse(OldPosition, SlateApp.GetInteractiveTopLevelWindows());
-		if (WidgetPath.IsValid())
+		// See if we are hovered over a widget or not. ResolveHover charges the frame budget itself.
+		const uint32 HoverStartCycles = FPlatformTime::Cycles();
+		FCursorResponseOverride Response;
+		if (ResolveHover(SlateApp, OldPosition))
 		{
-			for (int32 i = WidgetPath.Widgets.Num() - 1; i >= 0; --i)
+			Response = GetHoveredResponse();
+			if (bUseHoveredTuning)
 			{
-				// Grab the widget
-				FArrangedWidget& ArrangedWidget = WidgetPath.Widgets[i];
-				TSharedRef<SWidget> Widget = ArrangedWidget.Widget;
-
-				// See if it is acceptable or not
-				if (IsWidgetInteractable(Widget))
-				{
-					HoveredWidgetName = Widget->GetType();
-					DragCo = DragCoHovered;
-					MaxSpeed = MaxSpeedHover;
-					break;
-				}
+				DragCo = ScaledTuning.DragCoHovered * Response.DragScale;
+				MaxSpeed = ScaledTuning.MaxSpeedHovered * Response.MaxSpeedScale;
 			}
 		}
+		const uint32 HoverCycles = FPlatformTime::Cycles() - HoverStartCycles;
 
-		// Grab the cursor acceleration
-		const FVector2D AccelFromAnalogStick = GetAnalogCursorAccelerationValue(GetAnalogValues(AnalogStick), DPIScale);
-
-		FVector2D NewAccelerationThisFrame = FVector2D::ZeroVector;
-		if (!Settings->GetAnalogCursorNoAcceleration())
+		// World-space widgets follow the same hover rules. The manager updates the interaction from a cached ray, so this is only a flag check.
+		if (HoveredWidgetName == NAME_None && WorldWidgetInteraction.IsValid() && WorldWidgetInteraction->IsOverInteractableWidget())
 		{
-			// Calculate a new velocity. RK4.
-			if (!AccelFromAnalogStick.IsZero() || !Velocity.IsZero())
+			HoveredWidgetName = WorldWidgetHoverName;
+			HoveredWidgetRect = WorldWidgetRect;
+			if (bUseHoveredTuning)
 			{
-				const FVector2D A1 = (AccelFromAnalogStick - (DragCo * Velocity)) * DeltaTime;
-				const FVector2D A2 = (AccelFromAnalogStick - (DragCo * (Velocity + (A1 * 0.5f)))) * DeltaTime;
-				const FVector2D A3 = (AccelFromAnalogStick - (DragCo * (Velocity + (A2 * 0.5f)))) * DeltaTime;
-				const FVector2D A4 = (AccelFromAnalogStick - (DragCo * (Velocity + A3))) * DeltaTime;
-				NewAccelerationThisFrame = (A1 + (2.0f * A2) + (2.0f * A3) + A4) / 6.0f;
-				Velocity += NewAccelerationThisFrame;
+				DragCo = ScaledTuning.DragCoHovered;
+				MaxSpeed = ScaledTuning.MaxSpeedHovered;
 			}
 		}
-		else
-		{
-			// Else, use what is coming straight from the analog stick
-			Velocity = AccelFromAnalogStick;
-		}
 
-		// If we are smaller than out min speed, zero it out
-		const float VelSizeSq = Velocity.SizeSquared();
-		if (VelSizeSq < (MinCursorSpeed * MinCursorSpeed))
+		// OldPosition is what has been on screen since last frame, and we just resolved what it hovers
+		RecordPositionHistory(FPlatformTime::Seconds(), OldPosition);
+
+		if (ScrollInput != ECursorScrollInput::None)
 		{
-			Velocity = FVector2D::ZeroVector;
+			TickScroll(SlateApp, OldPosition, DeltaTime);
 		}
-		else if (VelSizeSq > (MaxSpeed * MaxSpeed))
+
+		// Condition the stick input
+		const FVector2D RawAnalogValues = GetMoveInput();
+		const FVector2D ConditionedAnalogValues = InputConditioner.Condition(RawAnalogValues, DeltaTime);
+
+		// Grab the cursor acceleration
+		FVector2D AccelFromAnalogStick = GetAnalogCursorAccelerationValue(ConditionedAnalogValues);
+
+		// Interactable widgets nearby pull the moving cursor towards their centre and slow it down
+		if (MagnetismField.IsValid())
 		{
-			//also cap us if we are larger than our max speed
-			Velocity = Velocity.GetSafeNormal() * MaxSpeed;
+			const FCursorMagnetismSample Magnetism = MagnetismField->Sample(OldPosition);
+			DragCo *= 1.0f + (Magnetism.Friction * ScaledTuning.MagnetismFriction * Response.MagnetismFrictionScale);
+			if (!AccelFromAnalogStick.IsZero())
+			{
+				AccelFromAnalogStick += Magnetism.Pull * (AccelFromAnalogStick.Size() * ScaledTuning.MagnetismStrength * Response.MagnetismStrengthScale);
+			}
 		}
 
+		Velocity = IntegrateVelocity(Velocity, AccelFromAnalogStick, DragCo, ScaledTuning.MinSpeed, MaxSpeed, ScaledTuning.bNoAcceleration, DeltaTime);
+
 		//bool bClamped = false;
 		//FBox2D viewportClamp = FBox2D();
 
@@ -417,6 +622,11 @@ void FExtendedAnalogCursor::Tick(const float DeltaTime, FSlateApplication& Slate
 		FVector2D clampedPosition;
 		GetAbsoluteClampedPosition(nextPosition, clampedPosition);
 
+		if (InputConditioner.DiffersFromLegacy())
+		{
+			AccumulateConditioningStats(RawAnalogValues, bClampToViewport ? clampedPosition : nextPosition, DragCo, DeltaTime);
+		}
+
 
 		//store off the last cursor direction
 		if (!Velocity.IsZero())
@@ -435,9 +645,255 @@ void FExtendedAnalogCursor::Tick(const float DeltaTime, FSlateApplication& Slate
 		if (!AccelFromAnalogStick.IsZero())
 		{
 			bIsUsingAnalogCursor = true;
-			FSlateApplication::Get().SetCursorRadius(Settings->GetAnalogCursorRadius() * DPIScale);
+			RequestCursorRadius(ScaledTuning.CursorRadius);
+		}
+
+		FVector2D viewportPosition = FVector2D::ZeroVector;
+		FVector2D viewportVelocity = FVector2D::ZeroVector;
+		FGeometry viewportGeometry;
+		if (GetPlayerViewportGeometry(viewportGeometry))
+		{
+			viewportPosition = USlateBlueprintLibrary::AbsoluteToLocal(viewportGeometry, CurrentPosition) / viewportGeometry.GetLocalSize().ComponentMax(FVector2D(1.0f, 1.0f));
+			viewportVelocity = Velocity / viewportGeometry.GetAbsoluteSize().ComponentMax(FVector2D(1.0f, 1.0f));
+		}
+		PublishState(viewportPosition, viewportVelocity);
+
+#if WITH_VIRTUALCURSOR_DEBUG
+		if (bDebugging || bAnalogDebug)
+		{
+			FCursorDebugFrame DebugFrame;
+			DebugFrame.Position = CurrentPosition;
+			DebugFrame.Velocity = Velocity;
+			DebugFrame.ClampBounds = FSlateRect(viewportGeometry.LocalToAbsolute(FVector2D(Radius, Radius)), viewportGeometry.LocalToAbsolute(viewportGeometry.GetLocalSize() - FVector2D(Radius, Radius)));
+			DebugFrame.HoveredRect = HoveredWidgetRect;
+			DebugFrame.bHovered = IsHovered() && HoveredWidgetName != WorldWidgetHoverName;
+			DebugFrame.bClamped = bClampToViewport && clampedPosition != nextPosition;
+			DebugHistory.AddFrame(DebugFrame);
+		}
+#endif
+
+		FVirtualCursorFrameBudget& FrameBudget = FVirtualCursorFrameBudget::Get();
+		const uint32 TickCycles = FPlatformTime::Cycles() - TickStartCycles;
+		FrameBudget.Charge(ECursorWorkPriority::Physics, TickCycles - HoverCycles);
+
+		FVirtualCursorTelemetry* Telemetry = FVirtualCursorTelemetry::Get();
+		if (Telemetry && FrameBudget.TryBegin(ECursorWorkPriority::Optional, StateSlot))
+		{
+			FCursorTelemetryRecord Record;
+			Record.FrameNumber = GFrameCounter;
+			Record.Time = FPlatformTime::Seconds();
+			Record.Position = CurrentPosition;
+			Record.Velocity = Velocity;
+			Record.HoveredWidget = HoveredWidgetName;
+			Record.UserIndex = GetOwnerUserIndex();
+			Record.bIsUsingAnalogCursor = bIsUsingAnalogCursor;
+			Record.TickCycles = TickCycles;
+			Telemetry->Record(Record);
+			FrameBudget.Charge(ECursorWorkPriority::Optional, FPlatformTime::Cycles() - TickStartCycles - TickCycles);
+		}
+		else if (Telemetry)
+		{
+			// Deferred by the frame budget; counted so gaps in the file can be told apart from a stalled cursor
+			Telemetry->CountDropped();
+		}
+	}
+}
+
+
+void FExtendedAnalogCursor::PublishState(const FVector2D& ViewportPosition, const FVector2D& ViewportVelocity)
+{
+	const int32 UserIndex = GetOwnerUserIndex();
+
+	FVirtualCursorSnapshot Snapshot;
+	Snapshot.Position = CurrentPosition;
+	Snapshot.Velocity = Velocity;
+	Snapshot.ViewportPosition = ViewportPosition;
+	Snapshot.ViewportVelocity = ViewportVelocity;
+	Snapshot.FrameNumber = GFrameCounter;
+	Snapshot.UserIndex = UserIndex;
+	Snapshot.bActive = true;
+	Snapshot.bIsUsingAnalogCursor = bIsUsingAnalogCursor;
+	Snapshot.bHovered = IsHovered();
+	FVirtualCursorStateBuffer::Get().Publish(StateSlot, Snapshot);
+
+	// The collection instance pushes its uniform buffer to the render thread itself
+	UMaterialParameterCollection* Collection = GetDefault<UCursorSettings>()->GetLoadedCursorParameterCollection();
+	if (Collection && UserIndex >= 0 && UserIndex < FVirtualCursorStateBuffer::MaxCursors)
+	{
+		static const FName ParameterNames[FVirtualCursorStateBuffer::MaxCursors] = {
+			TEXT("VirtualCursor0"), TEXT("VirtualCursor1"), TEXT("VirtualCursor2"), TEXT("VirtualCursor3"),
+			TEXT("VirtualCursor4"), TEXT("VirtualCursor5"), TEXT("VirtualCursor6"), TEXT("VirtualCursor7")
+		};
+
+		UWorld* World = PlayerContext.GetWorld();
+		if (UMaterialParameterCollectionInstance* Instance = World ? World->GetParameterCollectionInstance(Collection) : nullptr)
+		{
+			Instance->SetVectorParameterValue(ParameterNames[UserIndex], FLinearColor(ViewportPosition.X, ViewportPosition.Y, ViewportVelocity.X, ViewportVelocity.Y));
+		}
+	}
+}
+
+
+bool FExtendedAnalogCursor::ResolveHover(FSlateApplication& SlateApp, const FVector2D& Position)
+{
+	// Use the result resolved on a worker thread for this frame, if it was resolved at this position
+	if (PrecomputedHoverFrame == GFrameCounter && PrecomputedHoverPosition == Position)
+	{
+		const bool bHovered = ApplyHoverResult(PrecomputedHover);
+		if (CVarValidateParallelHover.GetValueOnGameThread() == 0)
+			return bHovered;
+
+		// Validation: resolve serially as well and compare
+		const FName ParallelWidgetName = HoveredWidgetName;
+		const bool bSerialHovered = ResolveHoverSerial(SlateApp, Position);
+		if (HoveredWidgetName != ParallelWidgetName)
+		{
+			UE_LOG(LogVirtualCursor, Warning, TEXT("Parallel hover mismatch for user %d at %s: parallel %s, serial %s"),
+				GetOwnerUserIndex(), *Position.ToString(), *ParallelWidgetName.ToString(), *HoveredWidgetName.ToString());
 		}
+		return bSerialHovered;
 	}
+
+	// Over budget: keep last frame's hover, but let the world widget check below refresh its own
+	FVirtualCursorFrameBudget& FrameBudget = FVirtualCursorFrameBudget::Get();
+	if (!FrameBudget.TryBegin(ECursorWorkPriority::Hover, StateSlot))
+	{
+		if (HoveredWidgetName == WorldWidgetHoverName)
+		{
+			HoveredWidgetName = NAME_None;
+		}
+		return IsHovered();
+	}
+
+	const uint32 StartCycles = FPlatformTime::Cycles();
+	const bool bHovered = ResolveHoverSerial(SlateApp, Position);
+	FrameBudget.Charge(ECursorWorkPriority::Hover, FPlatformTime::Cycles() - StartCycles);
+	return bHovered;
+}
+
+
+bool FExtendedAnalogCursor::ResolveHoverSerial(FSlateApplication& SlateApp, const FVector2D& Position)
+{
+	HoveredWidgetName = NAME_None;
+	HoveredWidget.Reset();
+
+	FWidgetPath WidgetPath = SlateApp.LocateWindowUnderMouse(Position, SlateApp.GetInteractiveTopLevelWindows());
+
+	// Scrolling sends its wheel event along this path instead of hit testing again
+	if (IsScrolling())
+	{
+		ScrollPath = WidgetPath;
+		ScrollPathFrame = GFrameCounter;
+	}
+
+	if (bTrackHoveredLayout)
+	{
+		HoveredLayoutName = WidgetPath.IsValid() ? FindLayoutName(WidgetPath) : NAME_None;
+	}
+	if (WidgetPath.IsValid())
+	{
+		for (int32 i = WidgetPath.Widgets.Num() - 1; i >= 0; --i)
+		{
+			// Grab the widget
+			FArrangedWidget& ArrangedWidget = WidgetPath.Widgets[i];
+			TSharedRef<SWidget> Widget = ArrangedWidget.Widget;
+
+			// See if it is acceptable or not
+			if (IsWidgetInteractable(Widget))
+			{
+				HoveredWidgetName = Widget->GetType();
+				HoveredWidgetRect = ArrangedWidget.Geometry.GetRenderBoundingRect();
+				HoveredWidget = Widget;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+
+bool FExtendedAnalogCursor::ApplyHoverResult(const FCursorHoverResult& Result)
+{
+	HoveredWidgetName = NAME_None;
+	HoveredWidget.Reset();
+
+	if (bTrackHoveredLayout)
+	{
+		HoveredLayoutName = Result.LayoutName;
+	}
+
+	if (Result.WidgetType == NAME_None || !Result.Widget.IsValid())
+		return false;
+
+	HoveredWidgetName = Result.WidgetType;
+	HoveredWidgetRect = Result.WidgetRect;
+	HoveredWidget = Result.Widget;
+	return true;
+}
+
+
+void FExtendedAnalogCursor::ResolveHoveredResponse()
+{
+	HoveredResponseWidget = HoveredWidget;
+	HoveredResponse = FCursorResponseOverride();
+
+	// Walk up, so tagging a container such as an icon grid covers every button in it
+	for (TSharedPtr<SWidget> Widget = HoveredWidget.Pin(); Widget.IsValid(); Widget = Widget->GetParentWidget())
+	{
+		if (TSharedPtr<FCursorResponseMetaData> MetaData = Widget->GetMetaData<FCursorResponseMetaData>())
+		{
+			HoveredResponse = MetaData->Response;
+			return;
+		}
+	}
+}
+
+
+void FExtendedAnalogCursor::SetPrecomputedHover(const FVector2D& Position, const FCursorHoverResult& Result)
+{
+	PrecomputedHover = Result;
+	PrecomputedHoverPosition = Position;
+	PrecomputedHoverFrame = GFrameCounter;
+}
+
+
+void FExtendedAnalogCursor::RecordPositionHistory(const double Time, const FVector2D& Position)
+{
+	PositionHistoryHead = (PositionHistoryHead + 1) % PositionHistorySize;
+
+	FPositionHistoryEntry& Entry = PositionHistory[PositionHistoryHead];
+	Entry.Time = Time;
+	Entry.Position = Position;
+	Entry.HoveredWidget = HoveredWidget;
+}
+
+
+bool FExtendedAnalogCursor::ResolveClickPosition(const double EventTime, FVector2D& OutPosition) const
+{
+	const float Compensation = GetDefault<UCursorSettings>()->GetClickLatencyCompensation();
+	if (Compensation <= 0.0f || PositionHistoryHead == INDEX_NONE || !bIsUsingAnalogCursor)
+		return false;
+
+	// Walk back from the newest entry, at most PositionHistorySize steps
+	const double TargetTime = EventTime - Compensation;
+	const FPositionHistoryEntry* Found = nullptr;
+	for (int32 Step = 0; Step < PositionHistorySize; ++Step)
+	{
+		const FPositionHistoryEntry& Entry = PositionHistory[(PositionHistoryHead - Step + PositionHistorySize) % PositionHistorySize];
+		if (Entry.Time <= 0.0)
+			break;
+
+		Found = &Entry;
+		if (Entry.Time <= TargetTime)
+			break;
+	}
+
+	// Same widget then and now, the click lands in the same place without any extra hit testing
+	if (!Found || Found->HoveredWidget == HoveredWidget)
+		return false;
+
+	OutPosition = Found->Position;
+	return true;
 }
 
 
@@ -445,7 +901,7 @@ void FExtendedAnalogCursor::SetClampToViewport(bool bNewClampToViewport)
 {
 	bClampToViewport = bNewClampToViewport;
 
-	if (!bClampToViewport || !bIsUsingAnalogCursor || !IsValid(GEngine) || !IsValid(GEngine->GameViewport))
+	if (!bClampToViewport || !bIsUsingAnalogCursor)
 		return;
 
 	FVector2D clampedPosition;
@@ -460,17 +916,172 @@ void FExtendedAnalogCursor::SetClampToViewport(bool bNewClampToViewport)
 }
 
 
-bool FExtendedAnalogCursor::GetAbsoluteClampedPosition(const FVector2D& inPosition, FVector2D& outPosition)
+void FExtendedAnalogCursor::Rebind(ULocalPlayer* InLocalPlayer, UWorld* InWorld)
+{
+	PlayerContext = FLocalPlayerContext(InLocalPlayer, InWorld);
+
+	// Push our position back to the Slate user, otherwise the next Tick will 
+	// think the mouse moved and drop the analog state.
+	if (bIsUsingAnalogCursor && InLocalPlayer && InLocalPlayer->GetSlateUser().IsValid() && CurrentPosition.X != FLT_MAX)
+	{
+		InLocalPlayer->GetSlateUser()->SetCursorPosition(FVector2D(FMath::TruncToFloat(CurrentPosition.X), FMath::TruncToFloat(CurrentPosition.Y)));
+	}
+}
+
+
+bool FExtendedAnalogCursor::BeginLoadingTick()
+{
+	check(IsInGameThread());
+	if (bLoadingTickActive || CurrentPosition.X == FLT_MAX || !PlayerContext.IsValid() || !PlayerContext.GetPlayerController())
+		return false;
+
+	RefreshTuning();
+	RefreshScaledTuning();
+
+	FScopeLock Lock(&LoadingStateLock);
+	LoadingState.Position = CurrentPosition;
+	LoadingState.Velocity = Velocity;
+	LoadingState.UserIndex = GetOwnerUserIndex();
+	LoadingState.StateSlot = StateSlot;
+	LoadingState.FrameNumber = GFrameCounter;
+	LoadingState.bIsUsingAnalogCursor = bIsUsingAnalogCursor;
+	LoadingState.Stick = GetMoveInput();
+	LoadingState.StickTime = FPlatformTime::Seconds();
+	LoadingState.Conditioner = InputConditioner;
+	LoadingState.AccelerationScale = ScaledTuning.AccelerationScale;
+	LoadingState.DragCo = ScaledTuning.DragCo;
+	LoadingState.MinSpeed = ScaledTuning.MinSpeed;
+	LoadingState.MaxSpeed = ScaledTuning.MaxSpeed;
+	LoadingState.bNoAcceleration = ScaledTuning.bNoAcceleration;
+	LoadingState.bClamp = false;
+
+	FGeometry ViewportGeometry;
+	if (GetPlayerViewportGeometry(ViewportGeometry))
+	{
+		const FVector2D LocalSize = ViewportGeometry.GetLocalSize();
+		LoadingState.ViewportBounds = FSlateRect(ViewportGeometry.LocalToAbsolute(FVector2D::ZeroVector), ViewportGeometry.LocalToAbsolute(LocalSize));
+		LoadingState.ClampBounds = FSlateRect(ViewportGeometry.LocalToAbsolute(FVector2D(Radius, Radius)), ViewportGeometry.LocalToAbsolute(LocalSize - FVector2D(Radius, Radius)));
+		LoadingState.bClamp = bClampToViewport;
+	}
+
+	// The loading thread claims the slot before it first publishes
+	FVirtualCursorStateBuffer::Get().ReleaseWriter(StateSlot);
+	bLoadingTickActive = true;
+	return true;
+}
+
+
+void FExtendedAnalogCursor::EndLoadingTick()
+{
+	check(IsInGameThread());
+	if (!bLoadingTickActive)
+		return;
+
+	FScopeLock Lock(&LoadingStateLock);
+	CurrentPosition = LoadingState.Position;
+	Velocity = LoadingState.Velocity;
+	InputConditioner = LoadingState.Conditioner;
+	if (!Velocity.IsZero())
+	{
+		LastCursorDirection = Velocity.GetSafeNormal();
+	}
+
+	FVirtualCursorStateBuffer::Get().ClaimWriter(StateSlot);
+	bPendingLoadingHandBack = true;
+	bLoadingTickActive = false;
+}
+
+
+void FExtendedAnalogCursor::MoveSlateCursorToLoadingPosition(FSlateApplication& SlateApp, const FInputEvent& InputEvent)
 {
-	if (!IsValid(GEngine) || !IsValid(GEngine->GameViewport))
+	TSharedPtr<FSlateUser> SlateUser = SlateApp.GetUser(InputEvent);
+	if (!SlateUser.IsValid())
+		return;
+
+	FVector2D Position;
+	{
+		FScopeLock Lock(&LoadingStateLock);
+		Position = LoadingState.Position;
+	}
+	SlateUser->SetCursorPosition(Position);
+}
+
+
+void FExtendedAnalogCursor::TickLoading(const double Time, const float DeltaTime)
+{
+	// Input that stopped arriving means nothing is pumping it, not that the stick is still held
+	static const double StaleInputSeconds = 0.2;
+
+	FVirtualCursorSnapshot Snapshot;
+	int32 Slot = INDEX_NONE;
+	{
+		FScopeLock Lock(&LoadingStateLock);
+		FLoadingState& State = LoadingState;
+
+		const FVector2D Stick = (Time - State.StickTime) < StaleInputSeconds ? State.Stick : FVector2D::ZeroVector;
+		const FVector2D Acceleration = State.Conditioner.Condition(Stick, DeltaTime) * State.AccelerationScale;
+		State.Velocity = IntegrateVelocity(State.Velocity, Acceleration, State.DragCo, State.MinSpeed, State.MaxSpeed, State.bNoAcceleration, DeltaTime);
+
+		FVector2D NextPosition = State.Position + (State.Velocity * DeltaTime);
+		if (State.bClamp)
+		{
+			NextPosition.X = FMath::Clamp(NextPosition.X, State.ClampBounds.Left, State.ClampBounds.Right);
+			NextPosition.Y = FMath::Clamp(NextPosition.Y, State.ClampBounds.Top, State.ClampBounds.Bottom);
+		}
+		State.Position = NextPosition;
+
+		Snapshot.Position = State.Position;
+		Snapshot.Velocity = State.Velocity;
+		Snapshot.UserIndex = State.UserIndex;
+		const FVector2D ViewportSize = State.ViewportBounds.GetSize().ComponentMax(FVector2D(1.0f, 1.0f));
+		Snapshot.ViewportPosition = (State.Position - State.ViewportBounds.GetTopLeft()) / ViewportSize;
+		Snapshot.ViewportVelocity = State.Velocity / ViewportSize;
+		Snapshot.FrameNumber = State.FrameNumber;
+		Snapshot.bIsUsingAnalogCursor = State.bIsUsingAnalogCursor;
+		Slot = State.StateSlot;
+	}
+
+	Snapshot.bActive = true;
+	FVirtualCursorStateBuffer::Get().Publish(Slot, Snapshot);
+}
+
+
+bool FExtendedAnalogCursor::GetPlayerViewportGeometry(FGeometry& outGeometry) const
+{
+	// Each PIE instance or in-process client has its own game viewport, and GEngine->GameViewport is only one of them
+	ULocalPlayer* localPlayer = PlayerContext.GetLocalPlayer();
+	if (!localPlayer || !IsValid(localPlayer->ViewportClient))
 		return false;
 
-	TSharedPtr<IGameLayerManager> gameLayerManager = GEngine->GameViewport->GetGameLayerManager();
+	TSharedPtr<IGameLayerManager> gameLayerManager = localPlayer->ViewportClient->GetGameLayerManager();
 	if (!gameLayerManager.IsValid())
 		return false;
 
+	outGeometry = gameLayerManager->GetPlayerWidgetHostGeometry(PlayerContext.GetLocalPlayer());
+	return true;
+}
+
+
+void FExtendedAnalogCursor::RequestCursorRadius(const float InRadius)
+{
+	if (RequestedCursorRadius == InRadius)
+		return;
+
+	RequestedCursorRadius = InRadius;
+	if (FVirtualCursorPlugin::IsAvailable())
+	{
+		FVirtualCursorPlugin::Get().GetTicker().UpdateCursorRadius();
+	}
+}
+
+
+bool FExtendedAnalogCursor::GetAbsoluteClampedPosition(const FVector2D& inPosition, FVector2D& outPosition)
+{
+	FGeometry viewportGeometry;
+	if (!GetPlayerViewportGeometry(viewportGeometry))
+		return false;
+
 	bool bClamped = false;
-	const FGeometry viewportGeometry = gameLayerManager->GetPlayerWidgetHostGeometry(PlayerContext.GetLocalPlayer());
 	const FVector2D playerViewportSize = viewportGeometry.GetLocalSize().RoundToVector();
 	FVector2D localPosition = USlateBlueprintLibrary::AbsoluteToLocal(viewportGeometry, inPosition);
 
@@ -500,34 +1111,212 @@ bool FExtendedAnalogCursor::GetAbsoluteClampedPosition(const FVector2D& inPositi
 }
 
 
-FVector2D FExtendedAnalogCursor::GetAnalogCursorAccelerationValue(const FVector2D& InAnalogValues, const float DPIScale) const
+FVector2D FExtendedAnalogCursor::IntegrateVelocity(const FVector2D& InVelocity, const FVector2D& Acceleration, const float DragCo, const float MinSpeed, const float InMaxSpeed, const bool bNoAcceleration, const float DeltaTime)
 {
-	const UCursorSettings* Settings = GetDefault<UCursorSettings>();
+	FVector2D NewVelocity = InVelocity;
+	if (!bNoAcceleration)
+	{
+		// Calculate a new velocity. RK4.
+		if (!Acceleration.IsZero() || !InVelocity.IsZero())
+		{
+			const FVector2D A1 = (Acceleration - (DragCo * InVelocity)) * DeltaTime;
+			const FVector2D A2 = (Acceleration - (DragCo * (InVelocity + (A1 * 0.5f)))) * DeltaTime;
+			const FVector2D A3 = (Acceleration - (DragCo * (InVelocity + (A2 * 0.5f)))) * DeltaTime;
+			const FVector2D A4 = (Acceleration - (DragCo * (InVelocity + A3))) * DeltaTime;
+			NewVelocity += (A1 + (2.0f * A2) + (2.0f * A3) + A4) / 6.0f;
+		}
+	}
+	else
+	{
+		// Else, use what is coming straight from the analog stick
+		NewVelocity = Acceleration;
+	}
 
-	FVector2D RetValue = FVector2D::ZeroVector;
-	if (const FRichCurve* AccelerationCurve = Settings->GetAnalogCursorAccelerationCurve())
+	// If we are smaller than out min speed, zero it out
+	const float VelSizeSq = NewVelocity.SizeSquared();
+	if (VelSizeSq < (MinSpeed * MinSpeed))
+	{
+		return FVector2D::ZeroVector;
+	}
+	if (VelSizeSq > (InMaxSpeed * InMaxSpeed))
 	{
-		const float DeadZoneSize = Settings->GetAnalogCursorDeadZone();
-		const float AnalogValSize = InAnalogValues.Size();
-		if (AnalogValSize > DeadZoneSize)
+		//also cap us if we are larger than our max speed
+		return NewVelocity.GetSafeNormal() * InMaxSpeed;
+	}
+	return NewVelocity;
+}
+
+
+FVector2D FExtendedAnalogCursor::GetPlayerViewportSize() const
+{
+	return UWidgetLayoutLibrary::GetViewportSize(PlayerContext.GetPlayerController());
+}
+
+
+void FExtendedAnalogCursor::SetMagnetismEnabled(const bool bEnabled)
+{
+	bMagnetismEnabled = bEnabled;
+	if (!bEnabled)
+	{
+		MagnetismField.Reset();
+	}
+}
+
+
+void FExtendedAnalogCursor::SetMagnetismField(const TSharedPtr<const FCursorMagnetismField, ESPMode::ThreadSafe>& Field)
+{
+	if (bMagnetismEnabled)
+	{
+		MagnetismField = Field;
+	}
+}
+
+
+void FExtendedAnalogCursor::SetProfile(const UCursorProfile* InProfile)
+{
+	Profile = InProfile;
+	ApplyTuning(InProfile);
+}
+
+
+void FExtendedAnalogCursor::ApplyTuning(const UCursorProfile* Source)
+{
+	if (Source)
+	{
+		const FCompiledCursorProfile& Compiled = Source->GetCompiled();
+		Tuning = Compiled.Tuning;
+		InputConditioner = Compiled.Conditioner;
+		TuningRevision = Compiled.Revision;
+	}
+	else
+	{
+		FCursorConditioningParams Params;
+		GetDefault<UCursorSettings>()->GetTuning().Compile(Tuning, Params);
+		InputConditioner.Compile(Params, UCursorSettings::GetRevision());
+		TuningRevision = UCursorSettings::GetRevision();
+	}
+	TuningSource = Source;
+
+	// Force a rescale on the next tick
+	ScaledTuningViewportSize = FVector2D::ZeroVector;
+}
+
+
+void FExtendedAnalogCursor::RefreshScaledTuning()
+{
+	const FVector2D ViewportSize = GetPlayerViewportSize();
+	if (ViewportSize != ScaledTuningViewportSize || ViewportSize.IsZero())
+	{
+		const float DPIScale = GetDefault<UUserInterfaceSettings>()->GetDPIScaleBasedOnSize(FIntPoint(FMath::RoundToInt(ViewportSize.X), FMath::RoundToInt(ViewportSize.Y)));
+		ScaledTuning = Tuning.GetScaled(DPIScale);
+		ScaledTuningViewportSize = ViewportSize;
+	}
+}
+
+
+void FExtendedAnalogCursor::AccumulateConditioningStats(const FVector2D& RawAnalogValues, const FVector2D& NextPosition, const float DragCo, const float DeltaTime)
+{
+	const FVector2D LegacyAccel = GetAnalogCursorAccelerationValue(InputConditioner.ConditionLegacy(RawAnalogValues));
+	if (LegacyAccel.IsZero())
+		return;
+
+	// One Euler step of what the legacy path would have done from the same starting velocity
+	FVector2D LegacyVelocity = Velocity;
+	if (!ScaledTuning.bNoAcceleration)
+	{
+		LegacyVelocity += (LegacyAccel - (DragCo * Velocity)) * DeltaTime;
+	}
+	else
+	{
+		LegacyVelocity = LegacyAccel;
+	}
+	if (LegacyVelocity.SizeSquared() < (ScaledTuning.MinSpeed * ScaledTuning.MinSpeed))
+		return;
+
+	const FVector2D LegacyPosition = CurrentPosition + (LegacyVelocity.GetClampedToMaxSize(MaxSpeed) * DeltaTime);
+	const auto IsSamePixel = [](const FVector2D& A, const FVector2D& B)
+	{
+		return FMath::TruncToInt(A.X) == FMath::TruncToInt(B.X) && FMath::TruncToInt(A.Y) == FMath::TruncToInt(B.Y);
+	};
+
+	if (IsSamePixel(NextPosition, CurrentPosition) && !IsSamePixel(LegacyPosition, CurrentPosition))
+	{
+		++SuppressedMoveCount;
+		if (IsHovered() && !HoveredWidgetRect.ContainsPoint(LegacyPosition))
 		{
-			RetValue = AccelerationCurve->Eval(AnalogValSize) * InAnalogValues.GetSafeNormal() * DPIScale;
-			RetValue *= Settings->GetAnalogCursorAccelerationMultiplier() * DPIScale;
+			++SuppressedHoverChangeCount;
 		}
 	}
-	return RetValue;
 }
 
 
-bool FExtendedAnalogCursor::IsCursorStickInput(const FAnalogInputEvent& AnalogInputEvent) const
+void FExtendedAnalogCursor::SetScrollInput(const ECursorScrollInput InScrollInput)
+{
+	ScrollInput = InScrollInput;
+	RoleValues[static_cast<uint8>(ECursorInputRole::Scroll)] = 0.0f;
+	ScrollAccumulator = 0.0f;
+	ScrollPath = FWidgetPath();
+}
+
+
+void FExtendedAnalogCursor::TickScroll(FSlateApplication& SlateApp, const FVector2D& Position, const float DeltaTime)
+{
+	// Past the dead zone and squared, so small deflections scroll finely
+	const float Input = GetRoleValue(ECursorInputRole::Scroll);
+	const float DeadZone = ScaledTuning.ScrollDeadZone;
+	const float Deflection = FMath::Clamp((FMath::Abs(Input) - DeadZone) / (1.0f - DeadZone), 0.0f, 1.0f);
+	if (Deflection == 0.0f)
+	{
+		// Drop the partial step, so letting go never scrolls any further
+		ScrollAccumulator = 0.0f;
+		ScrollPath = FWidgetPath();
+		return;
+	}
+
+	ScrollAccumulator += FMath::Sign(Input) * Deflection * Deflection * ScaledTuning.ScrollSpeed * DeltaTime;
+	const float WheelDelta = FMath::TruncToFloat(ScrollAccumulator / ScaledTuning.ScrollStep) * ScaledTuning.ScrollStep;
+	if (WheelDelta == 0.0f)
+	{
+		ScrollPath = FWidgetPath();
+		return;
+	}
+
+	ScrollAccumulator -= WheelDelta;
+
+	// Hover came from the parallel snapshot or was deferred, so there is no path for this frame yet
+	if (ScrollPathFrame != GFrameCounter)
+	{
+		ScrollPath = SlateApp.LocateWindowUnderMouse(Position, SlateApp.GetInteractiveTopLevelWindows());
+	}
+
+	if (ScrollPath.IsValid())
+	{
+		const FPointerEvent WheelEvent(GetOwnerUserIndex(), FSlateApplication::CursorPointerIndex, Position, Position, TSet<FKey>(), EKeys::MouseWheelAxis, WheelDelta, SlateApp.GetModifierKeys());
+		SlateApp.RouteMouseWheelOrGestureEvent(ScrollPath, WheelEvent, nullptr);
+	}
+
+	// Don't keep the widgets alive until next frame
+	ScrollPath = FWidgetPath();
+}
+
+
+const FCursorKeyBinding* FExtendedAnalogCursor::FindBinding(const FKey& Key)
+{
+	if (KeyBindings.IsStale(AnalogStick, ScrollInput))
+	{
+		KeyBindings.Build(AnalogStick, ScrollInput);
+		BindingValues.Init(0.0f, KeyBindings.GetNumSlots());
+		FMemory::Memzero(RoleValues);
+	}
+	return KeyBindings.Find(Key);
+}
+
+
+void FExtendedAnalogCursor::SetBindingValue(const FCursorKeyBinding& Binding, const float Value)
 {
-	return
-	  (AnalogStick == EAnalogStick::Left &&
-	  	(AnalogInputEvent.GetKey() == EKeys::Gamepad_LeftX || AnalogInputEvent.GetKey() == EKeys::Gamepad_LeftY)
-	  ) ||
-	  (AnalogStick == EAnalogStick::Right &&
-	  	(AnalogInputEvent.GetKey() == EKeys::Gamepad_RightX || AnalogInputEvent.GetKey() == EKeys::Gamepad_RightY)
-	  );
+	const float ScaledValue = Value * Binding.Scale;
+	RoleValues[static_cast<uint8>(Binding.Role)] += ScaledValue - BindingValues[Binding.Slot];
+	BindingValues[Binding.Slot] = ScaledValue;
 }
 
 
@@ -1,7 +1,18 @@
 #include "VirtualCursor/VirtualCursor.h"
 #include "VirtualCursor/CursorSettings.h"
+#include "VirtualCursor/CursorFrameBudget.h"
+#include "VirtualCursor/CursorHoverPrefetch.h"
+#include "VirtualCursor/CursorKeyBindings.h"
+#include "VirtualCursor/CursorTelemetry.h"
 #include "VirtualCursor/ExtendedAnalogCursor.h"
 #include "VirtualCursor/VirtualCursorManager.h"
+#include "VirtualCursor/VirtualCursorOverlay.h"
+#include "VirtualCursor/VirtualCursorTicker.h"
+#include "VirtualCursorPlugin.h"
+#include "Engine/Engine.h"
+#include "Engine/GameInstance.h"
+#include "Engine/LocalPlayer.h"
+#include "Components/Widget.h"
 
 
 void UVirtualCursor::Enable(class APlayerController* PlayerController, const bool bUseLeftStick)
@@ -28,6 +39,38 @@ void UVirtualCursor::Disable(class APlayerController* PlayerController)
 }
 
 
+void UVirtualCursor::EnableForAllLocalPlayers(const UObject* WorldContextObject, const bool bUseLeftStick)
+{
+	UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	if (World && World->GetGameInstance())
+	{
+		for (ULocalPlayer* LocalPlayer : World->GetGameInstance()->GetLocalPlayers())
+		{
+			if (UVirtualCursorManager* Manager = LocalPlayer ? LocalPlayer->GetSubsystem<UVirtualCursorManager>() : nullptr)
+			{
+				Manager->EnableAnalogCursor(bUseLeftStick);
+			}
+		}
+	}
+}
+
+
+void UVirtualCursor::DisableForAll(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	if (World && World->GetGameInstance())
+	{
+		for (ULocalPlayer* LocalPlayer : World->GetGameInstance()->GetLocalPlayers())
+		{
+			if (UVirtualCursorManager* Manager = LocalPlayer ? LocalPlayer->GetSubsystem<UVirtualCursorManager>() : nullptr)
+			{
+				Manager->DisableAnalogCursor();
+			}
+		}
+	}
+}
+
+
 bool UVirtualCursor::IsOverInteractableWidget(class APlayerController* PlayerController)
 {
 	if (PlayerController)
@@ -40,3 +83,143 @@ bool UVirtualCursor::IsOverInteractableWidget(class APlayerController* PlayerCon
 
 	return false;
 }
+
+
+void UVirtualCursor::ShowCursorOverlay(const UObject* WorldContextObject, const int32 ZOrder)
+{
+	UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	if (World && World->GetGameViewport())
+	{
+		FVirtualCursorPlugin::Get().ShowCursorOverlay(World->GetGameViewport(), ZOrder);
+	}
+}
+
+
+void UVirtualCursor::HideCursorOverlay(const UObject* WorldContextObject)
+{
+	UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+	if (World && World->GetGameViewport())
+	{
+		FVirtualCursorPlugin::Get().HideCursorOverlay(World->GetGameViewport());
+	}
+}
+
+
+void UVirtualCursor::SetCursorOverlayBrush(APlayerController* PlayerController, const FSlateBrush& Brush, const FLinearColor Tint)
+{
+	ULocalPlayer* LocalPlayer = PlayerController ? PlayerController->GetLocalPlayer() : nullptr;
+	if (LocalPlayer && LocalPlayer->ViewportClient)
+	{
+		FVirtualCursorPlugin::Get().GetCursorOverlay(LocalPlayer->ViewportClient).SetCursorBrush(LocalPlayer, Brush, Tint);
+	}
+}
+
+
+void UVirtualCursor::ClearCursorOverlayBrush(APlayerController* PlayerController)
+{
+	ULocalPlayer* LocalPlayer = PlayerController ? PlayerController->GetLocalPlayer() : nullptr;
+	if (LocalPlayer && LocalPlayer->ViewportClient)
+	{
+		FVirtualCursorPlugin::Get().GetCursorOverlay(LocalPlayer->ViewportClient).ClearCursorBrush(LocalPlayer);
+	}
+}
+
+
+bool UVirtualCursor::StartTelemetry(const FString& Filename)
+{
+	return FVirtualCursorTelemetry::Begin(Filename, GetDefault<UCursorSettings>()->GetTelemetryBufferCapacity());
+}
+
+
+void UVirtualCursor::StopTelemetry()
+{
+	FVirtualCursorTelemetry::End();
+}
+
+
+bool UVirtualCursor::GetTelemetryStats(int64& WrittenRecords, int64& DroppedRecords)
+{
+	if (const FVirtualCursorTelemetry* Telemetry = FVirtualCursorTelemetry::Get())
+	{
+		WrittenRecords = static_cast<int64>(Telemetry->GetWrittenCount());
+		DroppedRecords = static_cast<int64>(Telemetry->GetDroppedCount());
+		return true;
+	}
+
+	WrittenRecords = 0;
+	DroppedRecords = 0;
+	return false;
+}
+
+
+void UVirtualCursor::GetFrameBudgetStats(float& UsedMs, float& BudgetMs, int32& DeferredHover, int32& DeferredOptional)
+{
+	const FVirtualCursorFrameBudget& FrameBudget = FVirtualCursorFrameBudget::Get();
+	UsedMs = FrameBudget.GetLastFrameUsedMs();
+	BudgetMs = FrameBudget.GetBudgetMs();
+	DeferredHover = static_cast<int32>(FrameBudget.GetLastFrameDeferrals(ECursorWorkPriority::Hover));
+	DeferredOptional = static_cast<int32>(FrameBudget.GetLastFrameDeferrals(ECursorWorkPriority::Optional));
+}
+
+
+bool UVirtualCursor::SetCursorResponseOverride(UWidget* Widget, const FCursorResponseOverride& Response)
+{
+	TSharedPtr<SWidget> SlateWidget = Widget ? Widget->GetCachedWidget() : nullptr;
+	if (!SlateWidget.IsValid())
+		return false;
+
+	if (TSharedPtr<FCursorResponseMetaData> MetaData = SlateWidget->GetMetaData<FCursorResponseMetaData>())
+	{
+		MetaData->Response = Response;
+	}
+	else
+	{
+		SlateWidget->AddMetadata(MakeShared<FCursorResponseMetaData>(Response));
+	}
+	return true;
+}
+
+
+bool UVirtualCursor::RegisterHoverPrefetch(UWidget* Widget, const TArray<TSoftObjectPtr<UObject>>& Assets)
+{
+	TSharedPtr<SWidget> SlateWidget = Widget ? Widget->GetCachedWidget() : nullptr;
+	if (!SlateWidget.IsValid())
+		return false;
+
+	TSharedPtr<FCursorPrefetchMetaData> MetaData = SlateWidget->GetMetaData<FCursorPrefetchMetaData>();
+	if (!MetaData.IsValid())
+	{
+		MetaData = MakeShared<FCursorPrefetchMetaData>();
+		SlateWidget->AddMetadata(MetaData.ToSharedRef());
+	}
+
+	MetaData->Widget = Widget;
+	MetaData->Assets.Reset();
+	MetaData->Handle.Reset();
+	for (const TSoftObjectPtr<UObject>& Asset : Assets)
+	{
+		MetaData->Assets.Add(Asset.ToSoftObjectPath());
+	}
+	return true;
+}
+
+
+void UVirtualCursor::GetHoverPrefetchStats(int32& Predictions, int32& Hovers, int32& PredictedHovers)
+{
+	Predictions = 0;
+	Hovers = 0;
+	PredictedHovers = 0;
+	if (FVirtualCursorPlugin::IsAvailable())
+	{
+		const FCursorHoverPrefetcher& Prefetcher = FVirtualCursorPlugin::Get().GetTicker().GetHoverPrefetcher();
+		Predictions = static_cast<int32>(Prefetcher.GetPredictionCount());
+		Hovers = static_cast<int32>(Prefetcher.GetHoverCount());
+		PredictedHovers = static_cast<int32>(Prefetcher.GetHitCount());
+	}
+}
+
+
+void UVirtualCursor::RefreshCursorKeyBindings()
+{
+	FCursorKeyBindings::Invalidate();
+}
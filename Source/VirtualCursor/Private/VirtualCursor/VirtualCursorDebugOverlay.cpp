@@ -0,0 +1,148 @@
+#include "VirtualCursor/VirtualCursorDebugOverlay.h"
+
+#if WITH_VIRTUALCURSOR_DEBUG
+
+#include "VirtualCursor/CursorStateBuffer.h"
+#include "VirtualCursor/ExtendedAnalogCursor.h"
+#include "VirtualCursor/VirtualCursorManager.h"
+#include "Engine/GameInstance.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/LocalPlayer.h"
+#include "Rendering/DrawElements.h"
+#include "Styling/CoreStyle.h"
+
+
+/** How far ahead the velocity line reaches, in seconds of travel */
+static const float VelocityLineSeconds = 0.1f;
+
+/** Cap on cached input lines */
+static const int32 MaxInputLines = FCursorDebugHistory::NumInputs * FVirtualCursorStateBuffer::MaxCursors;
+
+
+void SVirtualCursorDebugOverlay::Construct(const FArguments& InArgs)
+{
+	ViewportClient = InArgs._ViewportClient;
+
+	// Everything it draws changes every frame
+	ForceVolatile(true);
+}
+
+
+FVector2D SVirtualCursorDebugOverlay::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	return FVector2D::ZeroVector;
+}
+
+
+int32 SVirtualCursorDebugOverlay::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	const UGameInstance* GameInstance = ViewportClient.IsValid() ? ViewportClient->GetGameInstance() : nullptr;
+	if (!GameInstance)
+		return LayerId;
+
+	const FPaintGeometry PaintGeometry = AllottedGeometry.ToPaintGeometry();
+	const FSlateFontInfo Font = FCoreStyle::GetDefaultFontStyle("Mono", 9);
+	const double Now = FPlatformTime::Seconds();
+
+	const auto DrawRect = [&](const FSlateRect& Rect, const FLinearColor& Color)
+	{
+		Points.Reset();
+		Points.Add(AllottedGeometry.AbsoluteToLocal(Rect.GetTopLeft()));
+		Points.Add(AllottedGeometry.AbsoluteToLocal(FVector2D(Rect.Right, Rect.Top)));
+		Points.Add(AllottedGeometry.AbsoluteToLocal(Rect.GetBottomRight()));
+		Points.Add(AllottedGeometry.AbsoluteToLocal(FVector2D(Rect.Left, Rect.Bottom)));
+		Points.Add(Points[0]);
+		FSlateDrawElement::MakeLines(OutDrawElements, LayerId, PaintGeometry, Points, ESlateDrawEffect::None, Color, true, 1.0f);
+	};
+
+	for (ULocalPlayer* LocalPlayer : GameInstance->GetLocalPlayers())
+	{
+		const UVirtualCursorManager* Manager = LocalPlayer ? LocalPlayer->GetSubsystem<UVirtualCursorManager>() : nullptr;
+		const TSharedPtr<FExtendedAnalogCursor> Cursor = Manager ? Manager->GetCursor() : nullptr;
+		if (!Cursor.IsValid() || !(Cursor->bDebugging || Cursor->bAnalogDebug))
+			continue;
+
+		const FCursorDebugHistory& History = Cursor->GetDebugHistory();
+		if (History.GetNumFrames() == 0)
+			continue;
+
+		const FCursorDebugFrame& Latest = History.GetFrame(0);
+		DrawRect(Latest.ClampBounds, Latest.bClamped ? FLinearColor::Red : FLinearColor(0.5f, 0.5f, 0.5f, 0.5f));
+		if (Latest.bHovered)
+		{
+			DrawRect(Latest.HoveredRect, FLinearColor::Green);
+		}
+
+		// Trail, oldest first
+		Points.Reset();
+		for (int32 Age = History.GetNumFrames() - 1; Age >= 0; --Age)
+		{
+			Points.Add(AllottedGeometry.AbsoluteToLocal(History.GetFrame(Age).Position));
+		}
+		FSlateDrawElement::MakeLines(OutDrawElements, LayerId, PaintGeometry, Points, ESlateDrawEffect::None, FLinearColor::Yellow, true, 1.0f);
+
+		const FVector2D LocalPosition = AllottedGeometry.AbsoluteToLocal(Latest.Position);
+		Points.Reset();
+		Points.Add(LocalPosition);
+		Points.Add(AllottedGeometry.AbsoluteToLocal(Latest.Position + (Latest.Velocity * VelocityLineSeconds)));
+		FSlateDrawElement::MakeLines(OutDrawElements, LayerId, PaintGeometry, Points, ESlateDrawEffect::None, FLinearColor(0.0f, 0.7f, 1.0f), true, 2.0f);
+
+		// Latest input under the cursor, newest on top, fading out over a few seconds
+		FVector2D TextPosition = LocalPosition + FVector2D(16.0f, 16.0f);
+		for (int32 Age = 0; Age < History.GetNumInputs(); ++Age)
+		{
+			const FCursorDebugInput& Input = History.GetInput(Age);
+			const float Opacity = 1.0f - FMath::Clamp(static_cast<float>(Now - Input.Time) / 3.0f, 0.0f, 1.0f);
+			if (Opacity <= 0.0f)
+				break;
+
+			FSlateDrawElement::MakeText(OutDrawElements, LayerId + 1, AllottedGeometry.ToPaintGeometry(FVector2D(400.0f, 14.0f), FSlateLayoutTransform(TextPosition)),
+				GetInputLine(Input), Font, ESlateDrawEffect::None, FLinearColor(1.0f, 1.0f, 1.0f, Opacity));
+			TextPosition.Y += 14.0f;
+		}
+	}
+
+	return LayerId + 1;
+}
+
+
+const FString& SVirtualCursorDebugOverlay::GetInputLine(const FCursorDebugInput& Input) const
+{
+	static const TCHAR* KindNames[] = { TEXT("Pressed"), TEXT("Held"), TEXT("Released"), TEXT("Analog") };
+
+	FInputLine* Line = InputLines.FindByPredicate([&Input](const FInputLine& Candidate)
+	{
+		return Candidate.Key == Input.Key && Candidate.Kind == Input.Kind && Candidate.Value == Input.Value;
+	});
+
+	if (!Line)
+	{
+		if (InputLines.Num() < MaxInputLines)
+		{
+			Line = &InputLines.AddDefaulted_GetRef();
+		}
+		else
+		{
+			Line = &InputLines[0];
+			for (FInputLine& Candidate : InputLines)
+			{
+				if (Candidate.LastPaintFrame < Line->LastPaintFrame)
+				{
+					Line = &Candidate;
+				}
+			}
+		}
+
+		Line->Key = Input.Key;
+		Line->Kind = Input.Kind;
+		Line->Value = Input.Value;
+		Line->Text = Input.Kind == ECursorDebugInput::Analog
+			? FString::Printf(TEXT("%s %+.2f"), *Input.Key.ToString(), Input.Value)
+			: FString::Printf(TEXT("%s %s"), *Input.Key.ToString(), KindNames[static_cast<int32>(Input.Kind)]);
+	}
+
+	Line->LastPaintFrame = GFrameCounter;
+	return Line->Text;
+}
+
+#endif // WITH_VIRTUALCURSOR_DEBUG
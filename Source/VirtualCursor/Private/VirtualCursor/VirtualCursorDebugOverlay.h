@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "VirtualCursor/CursorDebugHistory.h"
+
+#if WITH_VIRTUALCURSOR_DEBUG
+
+#include "Widgets/SLeafWidget.h"
+
+class UGameViewportClient;
+
+
+/**
+ * Draws the debug history of every cursor of one viewport's local players with debugging on, in a single paint:
+ * the recent trail, the velocity, the clamp bounds, the hovered widget's bounds and the latest input events.
+ * Owned by FVirtualCursorPlugin, which keeps one per viewport and only adds it while one of its players' cursors is being debugged.
+ */
+class SVirtualCursorDebugOverlay : public SLeafWidget
+{
+public:
+
+	SLATE_BEGIN_ARGS(SVirtualCursorDebugOverlay)
+	{
+		_Visibility = EVisibility::HitTestInvisible;
+	}
+		/** The viewport whose local players are drawn. Other PIE instances' cursors are in their own windows. */
+		SLATE_ARGUMENT(UGameViewportClient*, ViewportClient)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	// SWidget
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+
+protected:
+
+	// SWidget
+	virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+
+private:
+
+	/** Where the cursors come from */
+	TWeakObjectPtr<UGameViewportClient> ViewportClient;
+
+	/** Formats the line shown for Input, reusing the text of an earlier paint while the key, kind and value are unchanged */
+	const FString& GetInputLine(const FCursorDebugInput& Input) const;
+
+	/** Scratch for the trail, kept to avoid allocating every paint */
+	mutable TArray<FVector2D> Points;
+
+	struct FInputLine
+	{
+		FName Key;
+		ECursorDebugInput Kind = ECursorDebugInput::Pressed;
+		float Value = 0.0f;
+		FString Text;
+
+		/** GFrameCounter when the line was last drawn, the least recent one is replaced first */
+		uint64 LastPaintFrame = 0;
+	};
+
+	/** Formatted input lines, at most enough for every input of every cursor */
+	mutable TArray<FInputLine> InputLines;
+};
+
+#endif // WITH_VIRTUALCURSOR_DEBUG
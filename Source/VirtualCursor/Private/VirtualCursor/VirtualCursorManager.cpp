@@ -1,78 +1,284 @@
 #include "VirtualCursor/VirtualCursorManager.h"
 #include "VirtualCursor/ExtendedAnalogCursor.h"
+#include "VirtualCursor/CursorProfile.h"
 #include "VirtualCursor/CursorSettings.h"
+#include "VirtualCursor/CursorStateBuffer.h"
+#include "VirtualCursor/VirtualCursorTicker.h"
+#include "VirtualCursorPlugin.h"
+#include "Blueprint/SlateBlueprintLibrary.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Components/WidgetComponent.h"
+#include "Components/WidgetInteractionComponent.h"
+#include "GameFramework/PlayerController.h"
 #include "Framework/Application/SlateApplication.h"
 #include "GameMapsSettings.h"
 #include "Slate/SGameLayerManager.h"
 #include "Engine/Engine.h"
+#include "Engine/GameViewportClient.h"
+#include "Misc/Paths.h"
+#include "Widgets/SViewport.h"
 
 DEFINE_LOG_CATEGORY(LogVirtualCursorManager);
 
 
+/** Intersects a ray with the quad of a planar world-space widget component. Origin/Direction are in world space, Direction is normalized. */
+static bool IntersectWidgetQuad(UWidgetComponent* WidgetComponent, const FVector& Origin, const FVector& Direction, FHitResult& OutHit)
+{
+	if (!WidgetComponent->IsVisible() || WidgetComponent->GetWidgetSpace() != EWidgetSpace::World || WidgetComponent->GetGeometryMode() != EWidgetGeometryMode::Plane)
+		return false;
+
+	// The widget is drawn on the component's local YZ plane
+	const FTransform& ComponentTransform = WidgetComponent->GetComponentTransform();
+	const FVector LocalOrigin = ComponentTransform.InverseTransformPosition(Origin);
+	const FVector LocalDirection = ComponentTransform.InverseTransformVector(Direction);
+	if (FMath::IsNearlyZero(LocalDirection.X))
+		return false;
+
+	// The transform is affine, so the ray parameter is the same in both spaces
+	const float Distance = -LocalOrigin.X / LocalDirection.X;
+	if (Distance < 0.0f)
+		return false;
+
+	// Same local -> widget mapping as UWidgetComponent::GetLocalHitLocation
+	const FVector LocalHit = LocalOrigin + (LocalDirection * Distance);
+	const FVector2D DrawSize = WidgetComponent->GetCurrentDrawSize();
+	const FVector2D Pivot = WidgetComponent->GetPivot();
+	const float WidgetX = LocalHit.Y + (DrawSize.X * Pivot.X);
+	const float WidgetY = (DrawSize.Y * Pivot.Y) - LocalHit.Z;
+	if (WidgetX < 0.0f || WidgetX > DrawSize.X || WidgetY < 0.0f || WidgetY > DrawSize.Y)
+		return false;
+
+	OutHit = FHitResult(WidgetComponent->GetOwner(), WidgetComponent, Origin + (Direction * Distance), -Direction);
+	OutHit.bBlockingHit = true;
+	OutHit.Distance = Distance;
+	OutHit.TraceStart = Origin;
+	return true;
+}
+
+
+/** Absolute desktop bounds of a planar world-space widget component's quad as seen by PlayerController. False if part of it is behind the camera. */
+static bool ProjectWidgetQuad(UWidgetComponent* WidgetComponent, APlayerController* PlayerController, FSlateRect& OutRect)
+{
+	const FTransform& ComponentTransform = WidgetComponent->GetComponentTransform();
+	const FVector2D DrawSize = WidgetComponent->GetCurrentDrawSize();
+	const FVector2D Pivot = WidgetComponent->GetPivot();
+
+	// Inverse of the widget -> local mapping in IntersectWidgetQuad
+	const float Left = -DrawSize.X * Pivot.X;
+	const float Top = DrawSize.Y * Pivot.Y;
+	const FVector Corners[] =
+	{
+		FVector(0.0f, Left, Top),
+		FVector(0.0f, Left + DrawSize.X, Top),
+		FVector(0.0f, Left, Top - DrawSize.Y),
+		FVector(0.0f, Left + DrawSize.X, Top - DrawSize.Y)
+	};
+
+	FBox2D Bounds(ForceInit);
+	for (const FVector& Corner : Corners)
+	{
+		FVector2D PixelPosition, ViewportPosition, AbsolutePosition;
+		if (!PlayerController->ProjectWorldLocationToScreen(ComponentTransform.TransformPosition(Corner), PixelPosition))
+			return false;
+
+		USlateBlueprintLibrary::ScreenToViewport(PlayerController, PixelPosition, ViewportPosition);
+		USlateBlueprintLibrary::ViewportToAbsolute(PlayerController, ViewportPosition, AbsolutePosition);
+		Bounds += AbsolutePosition;
+	}
+
+	OutRect = FSlateRect(Bounds.Min, Bounds.Max);
+	return true;
+}
+
+
 void UVirtualCursorManager::Initialize(FSubsystemCollectionBase& Collection)
 {
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddUObject(this, &UVirtualCursorManager::HandlePostLoadMapWithWorld);
+	AnalogScrollInput = GetDefault<UCursorSettings>()->GetDefaultAnalogScrollInput();
+	InputConsumption[static_cast<uint8>(ECursorInputMode::UIOnly)] = GetDefault<UCursorSettings>()->GetInputConsumption(ECursorInputMode::UIOnly);
+	InputConsumption[static_cast<uint8>(ECursorInputMode::GameAndUI)] = GetDefault<UCursorSettings>()->GetInputConsumption(ECursorInputMode::GameAndUI);
+
+	if (FVirtualCursorPlugin::IsAvailable())
+	{
+		FVirtualCursorPlugin::Get().GetTicker().RegisterManager(this);
+	}
+
+	// Take over a cursor that survived the previous manager for this controller
+	if (GetDefault<UCursorSettings>()->GetPersistCursorState() && FVirtualCursorPlugin::IsAvailable())
+	{
+		bool bWasEnabled = false;
+		Cursor = FVirtualCursorPlugin::Get().ClaimParkedCursor(GetLocalPlayer()->GetGameInstance(), GetLocalPlayer()->GetControllerId(), bWasEnabled);
+		if (IsCursorValid())
+		{
+			Cursor->Rebind(GetLocalPlayer(), GetLocalPlayer()->GetWorld());
+			Cursor->SetProfile(CursorProfile);
+			Cursor->SetMagnetismEnabled(bMagnetismEnabled);
+			Cursor->SetScrollInput(AnalogScrollInput);
+			Cursor->SetInputConsumption(ECursorInputMode::UIOnly, InputConsumption[static_cast<uint8>(ECursorInputMode::UIOnly)]);
+			Cursor->SetInputConsumption(ECursorInputMode::GameAndUI, InputConsumption[static_cast<uint8>(ECursorInputMode::GameAndUI)]);
+			if (bWasEnabled && FSlateApplication::IsInitialized() && !ContainsGamepadCursorInputProcessor())
+			{
+				FSlateApplication::Get().RegisterInputPreProcessor(Cursor);
+			}
+		}
+	}
 }
 
 
 void UVirtualCursorManager::Deinitialize()
 {
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+
+	if (FVirtualCursorPlugin::IsAvailable())
+	{
+		FVirtualCursorPlugin::Get().GetTicker().UnregisterManager(this);
+
+		// Take the cursor back from the loading thread before parking or retiring it
+		if (IsCursorValid() && Cursor->IsLoadingTickActive())
+		{
+			FVirtualCursorPlugin::Get().EndLoadingTick();
+		}
+	}
+
+	// Hand the cursor over to the plugin so the next manager for this controller can pick it up
+	if (IsCursorValid() && GetDefault<UCursorSettings>()->GetPersistCursorState() && FVirtualCursorPlugin::IsAvailable())
+	{
+		const bool bWasEnabled = ContainsGamepadCursorInputProcessor();
+
+		// Unregister only, ParkCursor takes care of the cursor radius
+		if (bWasEnabled)
+		{
+			FSlateApplication::Get().UnregisterInputPreProcessor(Cursor);
+			FVirtualCursorStateBuffer::Get().Retire(Cursor->GetStateSlot());
+		}
+
+		FVirtualCursorPlugin::Get().ParkCursor(GetLocalPlayer()->GetGameInstance(), GetLocalPlayer()->GetControllerId(), Cursor, bWasEnabled);
+		Cursor.Reset();
+		return;
+	}
+
 	// When the local player is ending, cleanup the analog cursor and reset the shared ptr variable
 	DisableAnalogCursor();
 	Cursor.Reset();
 }
 
 
+void UVirtualCursorManager::HandlePostLoadMapWithWorld(UWorld* LoadedWorld)
+{
+	if (!IsCursorValid() || !LoadedWorld || !GetLocalPlayer())
+		return;
+
+	// Only rebind to worlds that belong to our game instance, other PIE instances load maps too
+	if (LoadedWorld->GetGameInstance() != GetLocalPlayer()->GetGameInstance())
+		return;
+
+	Cursor->Rebind(GetLocalPlayer(), LoadedWorld);
+}
+
+
 void UVirtualCursorManager::EnableAnalogCursor(const bool bUseLeftStick)
 {
 	// Ensure that slate and the world is valid
 	if (FSlateApplication::IsInitialized() && GetWorld())
 	{
-		const float CursorRadius = GetDefault<UCursorSettings>()->GetAnalogCursorRadius();
+		const float CursorRadius = CursorProfile ? CursorProfile->GetCompiled().Tuning.CursorRadius : GetDefault<UCursorSettings>()->GetTuning().GetCursorRadius();
 
 		// If the shared ptr isnt tied to a valid obj then create one and connect the two
-		if (!IsCursorValid())
+		if (IsCursorValid())
+		{
+			// An existing cursor may still point at the world it was created in
+			Cursor->Rebind(GetLocalPlayer(), GetWorld());
+		}
+		else
 		{
 			Cursor = MakeShareable(new FExtendedAnalogCursor(GetLocalPlayer(), GetWorld(), CursorRadius));
 			
 			const EAnalogStick Stick = bUseLeftStick ? EAnalogStick::Left : EAnalogStick::Right;
 			Cursor->SetStick(Stick);
 		}
+		Cursor->SetWorldWidgetInteraction(WidgetInteraction);
+		Cursor->SetTrackHoveredLayout(bHeatmapEnabled);
+		Cursor->SetProfile(CursorProfile);
+		Cursor->SetMagnetismEnabled(bMagnetismEnabled);
+		Cursor->SetScrollInput(AnalogScrollInput);
+		Cursor->SetInputConsumption(ECursorInputMode::UIOnly, InputConsumption[static_cast<uint8>(ECursorInputMode::UIOnly)]);
+		Cursor->SetInputConsumption(ECursorInputMode::GameAndUI, InputConsumption[static_cast<uint8>(ECursorInputMode::GameAndUI)]);
 
 		// Check that we're not re-adding it(which counts as a duplicate)
 		if (!ContainsGamepadCursorInputProcessor())
 		{
 			FSlateApplication::Get().RegisterInputPreProcessor(Cursor);
 
-			// Center the cursor in the player's respective viewport.
-			// This may not perfectly center if the viewport geometry's size is not properly divisible.
-			FVector2D cursorStartingPosition = FVector2D::ZeroVector;
-			if (IsValid(GEngine) && IsValid(GEngine->GameViewport))
-			{
-				TSharedPtr<IGameLayerManager> gameLayerManager = GEngine->GameViewport->GetGameLayerManager();
-				if (gameLayerManager.IsValid())
-				{
-					// Get the player's viewport geometry to determine where the cursor should be placed.
-					const FGeometry playerViewportGeometry = gameLayerManager->GetPlayerWidgetHostGeometry(GetLocalPlayer());
-					cursorStartingPosition = playerViewportGeometry.GetAbsolutePositionAtCoordinates(FVector2D(0.5f, 0.5f));
-				}
-			}
+			const FVector2D cursorStartingPosition = CenterCursor();
 
-			if (GetLocalPlayer()->GetSlateUser().IsValid())
+			if (GetDefault<UCursorSettings>()->GetSimulateClickOnEnable())
 			{
-				GetLocalPlayer()->GetSlateUser()->SetCursorPosition(cursorStartingPosition);
+				// Fake a button click so that the window has capture and focus. 
+				// Otherwise the cursor will not appear until the user presses a button.
+				FSlateApplication::Get().ProcessMouseButtonDownEvent(nullptr,FPointerEvent(GetLocalPlayer()->GetControllerId(), 0, cursorStartingPosition, cursorStartingPosition, 0.0f, true));
 			}
-			else
+			else if (!AcquireViewportFocusAndCapture())
 			{
-				// BUG! Why does this happen? Shouldn't the slate users be ready on application start?
-				UE_LOG(LogTemp, Warning, TEXT("UVirtualCursorManager::EnableAnalogCursor -- SlateUser for player %d is not valid."), GetLocalPlayer()->GetControllerId());
+				UE_LOG(LogVirtualCursorManager, Warning, TEXT("UVirtualCursorManager::EnableAnalogCursor -- Could not give focus and capture to the viewport of player %d."), GetLocalPlayer()->GetControllerId());
 			}
+		}
+		Cursor->RequestCursorRadius(CursorRadius);
+	}
+}
+
 
-			// Fake a button click so that the window has capture and focus. 
-			// Otherwise the cursor will not appear until the user presses a button.
-			FSlateApplication::Get().ProcessMouseButtonDownEvent(nullptr,FPointerEvent(GetLocalPlayer()->GetControllerId(), 0, cursorStartingPosition, cursorStartingPosition, 0.0f, true));
+FVector2D UVirtualCursorManager::CenterCursor() const
+{
+	// Center the cursor in the player's respective viewport.
+	// This may not perfectly center if the viewport geometry's size is not properly divisible.
+	// Use the player's own viewport client, GEngine->GameViewport belongs to whichever PIE instance started last.
+	FVector2D cursorStartingPosition = FVector2D::ZeroVector;
+	if (IsValid(GetLocalPlayer()->ViewportClient))
+	{
+		TSharedPtr<IGameLayerManager> gameLayerManager = GetLocalPlayer()->ViewportClient->GetGameLayerManager();
+		if (gameLayerManager.IsValid())
+		{
+			// Get the player's viewport geometry to determine where the cursor should be placed.
+			const FGeometry playerViewportGeometry = gameLayerManager->GetPlayerWidgetHostGeometry(GetLocalPlayer());
+			cursorStartingPosition = playerViewportGeometry.GetAbsolutePositionAtCoordinates(FVector2D(0.5f, 0.5f));
 		}
-		FSlateApplication::Get().SetCursorRadius(CursorRadius);
 	}
+
+	if (GetLocalPlayer()->GetSlateUser().IsValid())
+	{
+		GetLocalPlayer()->GetSlateUser()->SetCursorPosition(cursorStartingPosition);
+	}
+	else
+	{
+		// BUG! Why does this happen? Shouldn't the slate users be ready on application start?
+		UE_LOG(LogTemp, Warning, TEXT("UVirtualCursorManager::CenterCursor -- SlateUser for player %d is not valid."), GetLocalPlayer()->GetControllerId());
+	}
+
+	return cursorStartingPosition;
+}
+
+
+bool UVirtualCursorManager::AcquireViewportFocusAndCapture() const
+{
+	ULocalPlayer* LocalPlayer = GetLocalPlayer();
+	if (!LocalPlayer || !IsValid(LocalPlayer->ViewportClient) || !LocalPlayer->GetSlateUser().IsValid())
+		return false;
+
+	TSharedPtr<SViewport> viewportWidget = LocalPlayer->ViewportClient->GetGameViewportWidget();
+	if (!viewportWidget.IsValid())
+		return false;
+
+	FWidgetPath viewportPath;
+	if (!FSlateApplication::Get().FindPathToWidget(viewportWidget.ToSharedRef(), viewportPath))
+		return false;
+
+	// Process the same reply the viewport would have returned from a click, 
+	// but only for this user and without routing a click through the widgets under the cursor.
+	const FReply reply = FReply::Handled()
+		.SetUserFocus(viewportWidget.ToSharedRef(), EFocusCause::SetDirectly)
+		.CaptureMouse(viewportWidget.ToSharedRef());
+	FSlateApplication::Get().ProcessReply(viewportPath, reply, nullptr, nullptr, LocalPlayer->GetSlateUser()->GetUserIndex());
+	return true;
 }
 
 
@@ -83,9 +289,21 @@ void UVirtualCursorManager::DisableAnalogCursor()
 		// Dont try to remove it if we already removed it, you may say overkill I say ensuring safeguards
 		if (ContainsGamepadCursorInputProcessor())
 		{
+			if (Cursor->IsLoadingTickActive() && FVirtualCursorPlugin::IsAvailable())
+			{
+				FVirtualCursorPlugin::Get().EndLoadingTick();
+			}
+
 			FSlateApplication::Get().UnregisterInputPreProcessor(Cursor);
+			FVirtualCursorStateBuffer::Get().Retire(Cursor->GetStateSlot());
+			Cursor->RequestCursorRadius(0.0f);
+		}
+
+		// Other players' cursors may still be enabled, possibly in another PIE instance
+		if (FVirtualCursorPlugin::IsAvailable())
+		{
+			FVirtualCursorPlugin::Get().GetTicker().UpdateCursorRadius();
 		}
-		FSlateApplication::Get().SetCursorRadius(0.0f);
 	}
 }
 
@@ -95,8 +313,8 @@ void UVirtualCursorManager::ToggleCursorDebug()
 	if (IsCursorValid())
 	{
 		Cursor->bDebugging = !Cursor->bDebugging;
-		const FString BoolResult = ((Cursor->bDebugging) ? "true" : "false");
-		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Emerald, "Cursor Debug: " + BoolResult);
+		UE_LOG(LogVirtualCursorManager, Log, TEXT("Cursor Debug: %s"), Cursor->bDebugging ? TEXT("true") : TEXT("false"));
+		FVirtualCursorPlugin::Get().RefreshDebugOverlay(GetLocalPlayer()->ViewportClient);
 	}
 }
 
@@ -106,8 +324,8 @@ void UVirtualCursorManager::ToggleAnalogDebug()
 	if (IsCursorValid())
 	{
 		Cursor->bAnalogDebug = !Cursor->bAnalogDebug;
-		const FString BoolResult = ((Cursor->bAnalogDebug) ? "true" : "false");
-		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Emerald, "Analog Debug: " + BoolResult);
+		UE_LOG(LogVirtualCursorManager, Log, TEXT("Analog Debug: %s"), Cursor->bAnalogDebug ? TEXT("true") : TEXT("false"));
+		FVirtualCursorPlugin::Get().RefreshDebugOverlay(GetLocalPlayer()->ViewportClient);
 	}
 }
 
@@ -183,4 +401,412 @@ bool UVirtualCursorManager::CheckClampCursorToViewport() const
 		return Cursor->CheckClampToViewport();
 
 	return false;
-}
\ No newline at end of file
+}
+
+
+void UVirtualCursorManager::SetCursorProfile(UCursorProfile* Profile)
+{
+	CursorProfile = Profile;
+	if (IsCursorValid())
+	{
+		Cursor->SetProfile(CursorProfile);
+	}
+}
+
+
+UCursorProfile* UVirtualCursorManager::GetCursorProfile() const
+{
+	return CursorProfile;
+}
+
+
+void UVirtualCursorManager::SetMagnetismEnabled(const bool bEnabled)
+{
+	bMagnetismEnabled = bEnabled;
+	if (IsCursorValid())
+	{
+		Cursor->SetMagnetismEnabled(bEnabled);
+	}
+}
+
+
+bool UVirtualCursorManager::IsMagnetismEnabled() const
+{
+	return bMagnetismEnabled;
+}
+
+
+void UVirtualCursorManager::SetAnalogScrollInput(const ECursorScrollInput ScrollInput)
+{
+	AnalogScrollInput = ScrollInput;
+	if (IsCursorValid())
+	{
+		Cursor->SetScrollInput(ScrollInput);
+	}
+}
+
+
+ECursorScrollInput UVirtualCursorManager::GetAnalogScrollInput() const
+{
+	return AnalogScrollInput;
+}
+
+
+void UVirtualCursorManager::SetInputConsumption(const ECursorInputMode Mode, const FCursorInputConsumption& Consumption)
+{
+	if (Mode == ECursorInputMode::Num)
+		return;
+
+	InputConsumption[static_cast<uint8>(Mode)] = Consumption;
+	if (IsCursorValid())
+	{
+		Cursor->SetInputConsumption(Mode, Consumption);
+	}
+}
+
+
+FCursorInputConsumption UVirtualCursorManager::GetInputConsumption(const ECursorInputMode Mode) const
+{
+	return Mode == ECursorInputMode::Num ? FCursorInputConsumption() : InputConsumption[static_cast<uint8>(Mode)];
+}
+
+
+void UVirtualCursorManager::GetAbsorbedInputCounts(int32& Movement, int32& Clicks, int32& Scroll, int32& OtherGamepadKeys) const
+{
+	Movement = IsCursorValid() ? static_cast<int32>(Cursor->GetAbsorbedEventCount(ECursorInputRole::MoveX) + Cursor->GetAbsorbedEventCount(ECursorInputRole::MoveY)) : 0;
+	Clicks = IsCursorValid() ? static_cast<int32>(Cursor->GetAbsorbedEventCount(ECursorInputRole::Click)) : 0;
+	Scroll = IsCursorValid() ? static_cast<int32>(Cursor->GetAbsorbedEventCount(ECursorInputRole::Scroll)) : 0;
+	OtherGamepadKeys = IsCursorValid() ? static_cast<int32>(Cursor->GetAbsorbedEventCount(ECursorInputRole::None)) : 0;
+}
+
+
+void UVirtualCursorManager::ResetAbsorbedInputCounts()
+{
+	if (IsCursorValid())
+	{
+		Cursor->ResetAbsorbedEventCounts();
+	}
+}
+
+
+void UVirtualCursorManager::GetInputConditioningStats(int32& SuppressedMoves, int32& SuppressedHoverChanges) const
+{
+	SuppressedMoves = IsCursorValid() ? static_cast<int32>(Cursor->GetSuppressedMoveCount()) : 0;
+	SuppressedHoverChanges = IsCursorValid() ? static_cast<int32>(Cursor->GetSuppressedHoverChangeCount()) : 0;
+}
+
+
+void UVirtualCursorManager::ResetInputConditioningStats()
+{
+	if (IsCursorValid())
+	{
+		Cursor->ResetConditioningStats();
+	}
+}
+
+
+void UVirtualCursorManager::SetHeatmapEnabled(const bool bEnabled)
+{
+	if (bEnabled && !bHeatmapEnabled)
+	{
+		Heatmap.Reset(GetDefault<UCursorSettings>()->GetHeatmapResolution());
+	}
+
+	bHeatmapEnabled = bEnabled;
+	if (IsCursorValid())
+	{
+		Cursor->SetTrackHoveredLayout(bHeatmapEnabled);
+	}
+}
+
+
+bool UVirtualCursorManager::IsHeatmapEnabled() const
+{
+	return bHeatmapEnabled;
+}
+
+
+void UVirtualCursorManager::GetHeatmapLayouts(TArray<FName>& OutLayouts) const
+{
+	Heatmap.GetLayers().GetKeys(OutLayouts);
+}
+
+
+bool UVirtualCursorManager::GetHeatmap(const FName Layout, TArray<float>& OutDwellSeconds, TArray<float>& OutTravelSeconds, int32& OutWidth, int32& OutHeight) const
+{
+	OutWidth = Heatmap.GetResolution().X;
+	OutHeight = Heatmap.GetResolution().Y;
+
+	if (const FCursorHeatmapLayer* Layer = Heatmap.GetLayers().Find(Layout))
+	{
+		OutDwellSeconds = Layer->DwellSeconds;
+		OutTravelSeconds = Layer->TravelSeconds;
+		return true;
+	}
+
+	OutDwellSeconds.Reset();
+	OutTravelSeconds.Reset();
+	return false;
+}
+
+
+void UVirtualCursorManager::ExportHeatmaps(const FString& Directory)
+{
+	const FString ExportDirectory = !Directory.IsEmpty() ? Directory : FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("VirtualCursor"));
+
+	// Controller ids restart at 0 in every PIE instance, which would otherwise overwrite each other's files
+	const FWorldContext* WorldContext = GEngine ? GEngine->GetWorldContextFromWorld(GetLocalPlayer()->GetWorld()) : nullptr;
+	const int32 PIEInstance = WorldContext ? WorldContext->PIEInstance : INDEX_NONE;
+	const FString BaseName = PIEInstance != INDEX_NONE
+		? FString::Printf(TEXT("PIE%d_Player%d"), PIEInstance, GetLocalPlayer()->GetControllerId())
+		: FString::Printf(TEXT("Player%d"), GetLocalPlayer()->GetControllerId());
+	Heatmap.ExportAsync(ExportDirectory, BaseName);
+}
+
+
+void UVirtualCursorManager::AccumulateHeatmap(const float DeltaTime)
+{
+	if (!bHeatmapEnabled || !IsCursorValid())
+		return;
+
+	FVirtualCursorSnapshot Snapshot;
+	if (!FVirtualCursorStateBuffer::Get().Read(Cursor->GetStateSlot(), Snapshot) || !Snapshot.bActive)
+		return;
+
+	Heatmap.Accumulate(Cursor->GetHoveredLayoutName(), Snapshot.ViewportPosition, !Snapshot.Velocity.IsZero(), Cursor->GetHoveredWidgetName(), DeltaTime);
+}
+
+
+void UVirtualCursorManager::SetWorldPickEnabled(const bool bEnabled, const ECollisionChannel TraceChannel, const float TraceDistance)
+{
+	bWorldPickEnabled = bEnabled;
+	WorldPickChannel = TraceChannel;
+	WorldPickDistance = FMath::Max<float>(TraceDistance, 0.0f);
+	bWorldPickDirty = true;
+
+	if (!bWorldPickEnabled)
+	{
+		PendingWorldPick = FTraceHandle();
+		WorldPickResult = FHitResult();
+	}
+}
+
+
+bool UVirtualCursorManager::IsWorldPickEnabled() const
+{
+	return bWorldPickEnabled;
+}
+
+
+bool UVirtualCursorManager::GetWorldPickResult(FHitResult& OutHitResult) const
+{
+	OutHitResult = WorldPickResult;
+	return WorldPickResult.bBlockingHit;
+}
+
+
+void UVirtualCursorManager::UpdateCursorRay()
+{
+	bCursorRayChanged = false;
+
+	if (!bWorldPickEnabled && WorldWidgets.Num() == 0)
+		return;
+
+	APlayerController* PlayerController = GetLocalPlayer() ? GetLocalPlayer()->GetPlayerController(GetWorld()) : nullptr;
+	if (!IsCursorValid() || !PlayerController || !PlayerController->PlayerCameraManager)
+	{
+		CursorRay.bValid = false;
+		return;
+	}
+
+	const FVector2D CursorPosition = Cursor->GetCurrentPosition();
+	const FVector CameraLocation = PlayerController->PlayerCameraManager->GetCameraLocation();
+	const FRotator CameraRotation = PlayerController->PlayerCameraManager->GetCameraRotation();
+
+	if (CursorRay.bValid && CursorRay.CursorPosition == CursorPosition && CursorRay.CameraLocation == CameraLocation && CursorRay.CameraRotation == CameraRotation)
+		return;
+
+	// Absolute desktop position -> pixel position in the game viewport, then through this player's projection
+	FVector2D PixelPosition, ViewportPosition;
+	USlateBlueprintLibrary::AbsoluteToViewport(GetWorld(), CursorPosition, PixelPosition, ViewportPosition);
+
+	CursorRay.CursorPosition = CursorPosition;
+	CursorRay.CameraLocation = CameraLocation;
+	CursorRay.CameraRotation = CameraRotation;
+	CursorRay.bValid = PlayerController->DeprojectScreenPositionToWorld(PixelPosition.X, PixelPosition.Y, CursorRay.Origin, CursorRay.Direction);
+	bCursorRayChanged = CursorRay.bValid;
+}
+
+
+void UVirtualCursorManager::ConsumeWorldPick()
+{
+	UWorld* World = GetWorld();
+	if (!bWorldPickEnabled || !World || !World->IsTraceHandleValid(PendingWorldPick, false))
+		return;
+
+	FTraceDatum TraceData;
+	if (!World->QueryTraceData(PendingWorldPick, TraceData))
+		return;
+
+	PendingWorldPick = FTraceHandle();
+	WorldPickResult = TraceData.OutHits.Num() > 0 ? TraceData.OutHits[0] : FHitResult(TraceData.Start, TraceData.End);
+	OnWorldPick.Broadcast(WorldPickResult);
+}
+
+
+void UVirtualCursorManager::RequestWorldPick()
+{
+	UWorld* World = GetWorld();
+	if (!bWorldPickEnabled || !World || World->IsTraceHandleValid(PendingWorldPick, false))
+		return;
+
+	if (!CursorRay.bValid || (!bCursorRayChanged && !bWorldPickDirty))
+		return;
+
+	bWorldPickDirty = false;
+
+	// UpdateWorldWidgetHover only keeps a widget hit with nothing blocking in front of it, so it answers the pick without another trace
+	if (WorldWidgetHit.bBlockingHit)
+	{
+		WorldPickResult = WorldWidgetHit;
+		OnWorldPick.Broadcast(WorldPickResult);
+		return;
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(VirtualCursorWorldPick), true);
+	if (APlayerController* PlayerController = GetLocalPlayer()->GetPlayerController(World))
+	{
+		QueryParams.AddIgnoredActor(PlayerController->GetPawn());
+	}
+
+	const FVector TraceEnd = CursorRay.Origin + (CursorRay.Direction * WorldPickDistance);
+	PendingWorldPick = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, CursorRay.Origin, TraceEnd, WorldPickChannel, QueryParams);
+}
+
+
+void UVirtualCursorManager::RegisterWidgetComponent(UWidgetComponent* WidgetComponent)
+{
+	if (IsValid(WidgetComponent))
+	{
+		WorldWidgets.AddUnique(WidgetComponent);
+		bWorldWidgetsDirty = true;
+	}
+}
+
+
+void UVirtualCursorManager::UnregisterWidgetComponent(UWidgetComponent* WidgetComponent)
+{
+	if (WorldWidgets.Remove(WidgetComponent) > 0)
+	{
+		bWorldWidgetsDirty = true;
+	}
+}
+
+
+UWidgetComponent* UVirtualCursorManager::GetHoveredWidgetComponent() const
+{
+	return WorldWidgetHit.bBlockingHit ? Cast<UWidgetComponent>(WorldWidgetHit.GetComponent()) : nullptr;
+}
+
+
+UWidgetInteractionComponent* UVirtualCursorManager::GetOrCreateWidgetInteraction()
+{
+	APlayerController* PlayerController = GetLocalPlayer() ? GetLocalPlayer()->GetPlayerController(GetWorld()) : nullptr;
+	if (!PlayerController)
+		return nullptr;
+
+	// The component lives on the player controller, which is replaced on travel
+	if (IsValid(WidgetInteraction) && WidgetInteraction->GetOwner() == PlayerController)
+		return WidgetInteraction;
+
+	// A controller that outlived its player would otherwise keep hovering whatever it was over
+	if (IsValid(WidgetInteraction))
+	{
+		WidgetInteraction->SetCustomHitResult(FHitResult());
+		WidgetInteraction->DestroyComponent();
+	}
+
+	WidgetInteraction = NewObject<UWidgetInteractionComponent>(PlayerController, TEXT("VirtualCursorWidgetInteraction"));
+	WidgetInteraction->InteractionSource = EWidgetInteractionSource::Custom;
+	// Virtual Slate users are shared by every PIE instance, so use the slot, which unlike the controller id is unique
+	WidgetInteraction->VirtualUserIndex = IsCursorValid() && Cursor->GetStateSlot() != INDEX_NONE ? Cursor->GetStateSlot() : GetLocalPlayer()->GetControllerId();
+	WidgetInteraction->RegisterComponent();
+
+	if (IsCursorValid())
+	{
+		Cursor->SetWorldWidgetInteraction(WidgetInteraction);
+	}
+	return WidgetInteraction;
+}
+
+
+void UVirtualCursorManager::UpdateWorldWidgetHover()
+{
+	if (WorldWidgets.Num() == 0 && !bWorldWidgetsDirty)
+		return;
+
+	// A new controller or pawn after possession: move the interaction component over and retest, since the occlusion trace ignores the pawn
+	APlayerController* PlayerController = GetLocalPlayer() ? GetLocalPlayer()->GetPlayerController(GetWorld()) : nullptr;
+	APawn* Pawn = PlayerController ? PlayerController->GetPawn() : nullptr;
+	if (PlayerController != WidgetInteractionController.Get() || Pawn != WidgetInteractionPawn.Get())
+	{
+		WidgetInteractionController = PlayerController;
+		WidgetInteractionPawn = Pawn;
+		bWorldWidgetsDirty = true;
+	}
+
+	// Neither the ray nor the widgets changed, the cached hit still stands
+	if (!bCursorRayChanged && !bWorldWidgetsDirty)
+		return;
+
+	bWorldWidgetsDirty = false;
+	WorldWidgetHit = FHitResult();
+
+	if (CursorRay.bValid)
+	{
+		WorldWidgets.RemoveAll([](const TWeakObjectPtr<UWidgetComponent>& WidgetComponent) { return !WidgetComponent.IsValid(); });
+
+		FHitResult Hit;
+		for (const TWeakObjectPtr<UWidgetComponent>& WidgetComponent : WorldWidgets)
+		{
+			if (IntersectWidgetQuad(WidgetComponent.Get(), CursorRay.Origin, CursorRay.Direction, Hit) && (!WorldWidgetHit.bBlockingHit || Hit.Distance < WorldWidgetHit.Distance))
+			{
+				WorldWidgetHit = Hit;
+			}
+		}
+	}
+
+	// The quads are tested on their own, so a wall between the camera and the nearest one still has to be ruled out.
+	// This runs only when the ray or the widgets changed and a widget was hit, and stops short of the widget.
+	UWorld* World = GetWorld();
+	if (WorldWidgetHit.bBlockingHit && World)
+	{
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(VirtualCursorWorldWidgetOcclusion), true);
+		QueryParams.AddIgnoredActor(Pawn);
+		QueryParams.AddIgnoredComponent(WorldWidgetHit.GetComponent());
+
+		FHitResult Blocker;
+		if (World->LineTraceSingleByChannel(Blocker, CursorRay.Origin, WorldWidgetHit.ImpactPoint, WorldPickChannel, QueryParams)
+			&& Blocker.Distance < WorldWidgetHit.Distance)
+		{
+			WorldWidgetHit = FHitResult();
+		}
+	}
+
+	if (IsCursorValid())
+	{
+		UWidgetComponent* HoveredComponent = GetHoveredWidgetComponent();
+		FSlateRect WidgetRect;
+		if (!HoveredComponent || !PlayerController || !ProjectWidgetQuad(HoveredComponent, PlayerController, WidgetRect))
+		{
+			// Unknown bounds: a point rect at the cursor, so any move counts as leaving it
+			WidgetRect = FSlateRect(Cursor->GetCurrentPosition(), Cursor->GetCurrentPosition());
+		}
+		Cursor->SetWorldWidgetRect(WidgetRect);
+	}
+
+	if (UWidgetInteractionComponent* Interaction = GetOrCreateWidgetInteraction())
+	{
+		Interaction->SetCustomHitResult(WorldWidgetHit);
+	}
+}
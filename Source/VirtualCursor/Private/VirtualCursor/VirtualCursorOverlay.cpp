@@ -0,0 +1,133 @@
+#include "VirtualCursor/VirtualCursorOverlay.h"
+#include "VirtualCursor/CursorSettings.h"
+#include "VirtualCursor/ExtendedAnalogCursor.h"
+#include "VirtualCursor/VirtualCursorManager.h"
+#include "Engine/GameInstance.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/LocalPlayer.h"
+#include "Rendering/DrawElements.h"
+
+
+void SVirtualCursorOverlay::Construct(const FArguments& InArgs)
+{
+	ViewportClient = InArgs._ViewportClient;
+	RegisterActiveTimer(0.0f, FWidgetActiveTimerDelegate::CreateSP(this, &SVirtualCursorOverlay::UpdateCursors));
+}
+
+
+void SVirtualCursorOverlay::SetCursorBrush(const ULocalPlayer* LocalPlayer, const FSlateBrush& Brush, const FLinearColor& Tint)
+{
+	if (!LocalPlayer)
+		return;
+
+	FCursorStyle& Style = Styles.FindOrAdd(LocalPlayer);
+	Style.Brush = Brush;
+	Style.Tint = Tint;
+	Style.Resource.Reset(Brush.GetResourceObject());
+	Invalidate(EInvalidateWidgetReason::Paint);
+}
+
+
+void SVirtualCursorOverlay::ClearCursorBrush(const ULocalPlayer* LocalPlayer)
+{
+	if (Styles.Remove(LocalPlayer) > 0)
+	{
+		Invalidate(EInvalidateWidgetReason::Paint);
+	}
+}
+
+
+int32 SVirtualCursorOverlay::ReadCursors(FVirtualCursorSnapshot (&OutSnapshots)[FVirtualCursorStateBuffer::MaxCursors], TWeakObjectPtr<const ULocalPlayer> (&OutPlayers)[FVirtualCursorStateBuffer::MaxCursors]) const
+{
+	const FVirtualCursorStateBuffer& StateBuffer = FVirtualCursorStateBuffer::Get();
+	if (!ViewportClient.IsExplicitlyNull())
+	{
+		// Other PIE instances publish to the same buffer, but their cursors belong to their own viewports
+		const UGameInstance* GameInstance = ViewportClient.IsValid() ? ViewportClient->GetGameInstance() : nullptr;
+		if (!GameInstance)
+			return 0;
+
+		int32 Count = 0;
+		for (ULocalPlayer* LocalPlayer : GameInstance->GetLocalPlayers())
+		{
+			const UVirtualCursorManager* Manager = LocalPlayer ? LocalPlayer->GetSubsystem<UVirtualCursorManager>() : nullptr;
+			const TSharedPtr<FExtendedAnalogCursor> Cursor = Manager ? Manager->GetCursor() : nullptr;
+			if (Count < FVirtualCursorStateBuffer::MaxCursors && Cursor.IsValid() && StateBuffer.Read(Cursor->GetStateSlot(), OutSnapshots[Count]) && OutSnapshots[Count].bActive)
+			{
+				OutPlayers[Count++] = LocalPlayer;
+			}
+		}
+		return Count;
+	}
+
+	const int32 Count = StateBuffer.ReadAll(OutSnapshots);
+	for (int32 i = 0; i < Count; ++i)
+	{
+		OutPlayers[i].Reset();
+	}
+	return Count;
+}
+
+
+EActiveTimerReturnType SVirtualCursorOverlay::UpdateCursors(double InCurrentTime, float InDeltaTime)
+{
+	FVirtualCursorSnapshot Latest[FVirtualCursorStateBuffer::MaxCursors];
+	TWeakObjectPtr<const ULocalPlayer> LatestPlayers[FVirtualCursorStateBuffer::MaxCursors];
+	const int32 NumLatest = ReadCursors(Latest, LatestPlayers);
+
+	bool bChanged = NumLatest != NumCursors;
+	for (int32 i = 0; i < NumLatest && !bChanged; ++i)
+	{
+		bChanged = Latest[i].StateSlot != Cursors[i].StateSlot || Latest[i].Position != Cursors[i].Position || LatestPlayers[i] != CursorPlayers[i];
+	}
+
+	if (bChanged)
+	{
+		for (int32 i = 0; i < NumLatest; ++i)
+		{
+			Cursors[i] = Latest[i];
+			CursorPlayers[i] = LatestPlayers[i];
+		}
+		NumCursors = NumLatest;
+		Invalidate(EInvalidateWidgetReason::Paint);
+	}
+
+	return EActiveTimerReturnType::Continue;
+}
+
+
+FVector2D SVirtualCursorOverlay::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+	// Fills whatever the viewport gives it
+	return FVector2D::ZeroVector;
+}
+
+
+int32 SVirtualCursorOverlay::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	const UCursorSettings* Settings = GetDefault<UCursorSettings>();
+	const float Diameter = Settings->GetTuning().GetCursorRadius() * 2.0f;
+	const FVector2D Size(Diameter, Diameter);
+	const FSlateBrush* DefaultBrush = &Settings->GetCursorOverlayBrush();
+	const FLinearColor WidgetTint = InWidgetStyle.GetColorAndOpacityTint();
+
+	// Boxes sharing a brush end up in the same batch
+	for (int32 i = 0; i < NumCursors; ++i)
+	{
+		const FVirtualCursorSnapshot& Cursor = Cursors[i];
+		const FCursorStyle* Style = Styles.Find(CursorPlayers[i]);
+		const FSlateBrush* Brush = Style ? &Style->Brush : DefaultBrush;
+		const FLinearColor Tint = Style ? Style->Tint : FLinearColor::White;
+
+		const FVector2D LocalPosition = AllottedGeometry.AbsoluteToLocal(Cursor.Position) - (Size * 0.5f);
+		FSlateDrawElement::MakeBox(
+			OutDrawElements,
+			LayerId,
+			AllottedGeometry.ToPaintGeometry(Size, FSlateLayoutTransform(LocalPosition)),
+			Brush,
+			ESlateDrawEffect::None,
+			Brush->GetTint(InWidgetStyle) * Tint * WidgetTint);
+	}
+
+	return LayerId;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/StrongObjectPtr.h"
+#include "Widgets/SLeafWidget.h"
+#include "VirtualCursor/CursorStateBuffer.h"
+
+
+class UGameViewportClient;
+class ULocalPlayer;
+
+
+/**
+ * Draws the active virtual cursors of one game viewport's local players in a single paint, one box per cursor, 
+ * from the published cursor states. Without a viewport it draws every active cursor, with the brush from the settings.
+ * The widget never changes size, so it only ever invalidates its paint, and only on frames where a cursor moved,
+ * appeared, disappeared or changed brush.
+ * Owned by FVirtualCursorPlugin, one per game viewport client.
+ */
+class SVirtualCursorOverlay : public SLeafWidget
+{
+public:
+
+	SLATE_BEGIN_ARGS(SVirtualCursorOverlay)
+	{
+		_Visibility = EVisibility::HitTestInvisible;
+	}
+		/** The viewport whose local players are drawn, null for all cursors */
+		SLATE_ARGUMENT(UGameViewportClient*, ViewportClient)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	/** Overrides the brush and tint of one player's cursor. The brush is copied. */
+	void SetCursorBrush(const ULocalPlayer* LocalPlayer, const FSlateBrush& Brush, const FLinearColor& Tint);
+
+	/** Returns this player's cursor to the brush from the settings. */
+	void ClearCursorBrush(const ULocalPlayer* LocalPlayer);
+
+	// SWidget
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+
+protected:
+
+	// SWidget
+	virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+
+private:
+
+	/** Reads the cursor states and invalidates the paint if any cursor changed since the last one. */
+	EActiveTimerReturnType UpdateCursors(double InCurrentTime, float InDeltaTime);
+
+	/** Reads the states of the viewport's local players' cursors, or of every cursor without a viewport. Returns how many are active. */
+	int32 ReadCursors(FVirtualCursorSnapshot (&OutSnapshots)[FVirtualCursorStateBuffer::MaxCursors], TWeakObjectPtr<const ULocalPlayer> (&OutPlayers)[FVirtualCursorStateBuffer::MaxCursors]) const;
+
+	struct FCursorStyle
+	{
+		FSlateBrush Brush;
+		FLinearColor Tint = FLinearColor::White;
+
+		/** Keeps the brush's texture or material alive */
+		TStrongObjectPtr<UObject> Resource;
+	};
+
+	TWeakObjectPtr<UGameViewportClient> ViewportClient;
+
+	TMap<TWeakObjectPtr<const ULocalPlayer>, FCursorStyle> Styles;
+
+	/** The states drawn by OnPaint and the players they belong to, refreshed by UpdateCursors */
+	FVirtualCursorSnapshot Cursors[FVirtualCursorStateBuffer::MaxCursors];
+	TWeakObjectPtr<const ULocalPlayer> CursorPlayers[FVirtualCursorStateBuffer::MaxCursors];
+	int32 NumCursors = 0;
+};
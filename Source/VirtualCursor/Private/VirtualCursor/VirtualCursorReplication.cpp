@@ -0,0 +1,420 @@
+#include "VirtualCursor/VirtualCursorReplication.h"
+#include "VirtualCursor/CursorStateBuffer.h"
+#include "VirtualCursor/ExtendedAnalogCursor.h"
+#include "VirtualCursor/VirtualCursorManager.h"
+#include "Engine/LocalPlayer.h"
+#include "GameFramework/PlayerController.h"
+#include "Net/UnrealNetwork.h"
+
+
+/** Zigzag encoding, so small negative values pack as small as small positive ones */
+static uint32 ZigZagEncode(const int32 Value)
+{
+	return (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+}
+
+
+static int32 ZigZagDecode(const uint32 Encoded)
+{
+	return static_cast<int32>((Encoded >> 1) ^ (0u - (Encoded & 1)));
+}
+
+
+static void SerializeSignedPacked(FArchive& Ar, int32& Value)
+{
+	uint32 Encoded = ZigZagEncode(Value);
+	Ar.SerializeIntPacked(Encoded);
+	if (Ar.IsLoading())
+	{
+		Value = ZigZagDecode(Encoded);
+	}
+}
+
+
+static void SerializeSignedPacked(FArchive& Ar, int16& Value)
+{
+	int32 Wide = Value;
+	SerializeSignedPacked(Ar, Wide);
+	Value = static_cast<int16>(Wide);
+}
+
+
+void FReplicatedCursorState::Quantize(const FVector2D& ViewportPosition, const FVector2D& ViewportVelocity)
+{
+	X = static_cast<uint16>(FMath::RoundToInt(FMath::Clamp(ViewportPosition.X, 0.0f, 1.0f) * 65535.0f));
+	Y = static_cast<uint16>(FMath::RoundToInt(FMath::Clamp(ViewportPosition.Y, 0.0f, 1.0f) * 65535.0f));
+	VelocityX = static_cast<int16>(FMath::Clamp(FMath::RoundToInt(ViewportVelocity.X * VelocityScale), -32767, 32767));
+	VelocityY = static_cast<int16>(FMath::Clamp(FMath::RoundToInt(ViewportVelocity.Y * VelocityScale), -32767, 32767));
+}
+
+
+void FReplicatedCursorState::SetDeltaBase(const FReplicatedCursorState& Base)
+{
+	bDelta = true;
+	DeltaX = static_cast<int32>(X) - static_cast<int32>(Base.X);
+	DeltaY = static_cast<int32>(Y) - static_cast<int32>(Base.Y);
+}
+
+
+bool FReplicatedCursorState::ResolveDelta(const FReplicatedCursorState& Base)
+{
+	if (!bDelta)
+		return true;
+
+	if (!Base.bActive || Base.bDelta || static_cast<uint8>(Base.Sequence + 1) != Sequence)
+		return false;
+
+	X = static_cast<uint16>(FMath::Clamp(static_cast<int32>(Base.X) + DeltaX, 0, 65535));
+	Y = static_cast<uint16>(FMath::Clamp(static_cast<int32>(Base.Y) + DeltaY, 0, 65535));
+	bDelta = false;
+	DeltaX = 0;
+	DeltaY = 0;
+	return true;
+}
+
+
+bool FReplicatedCursorState::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	Ar << Sequence;
+
+	uint8 ActiveBit = bActive ? 1 : 0;
+	Ar.SerializeBits(&ActiveBit, 1);
+	bActive = ActiveBit != 0;
+
+	if (bActive)
+	{
+		uint8 DeltaBit = bDelta ? 1 : 0;
+		Ar.SerializeBits(&DeltaBit, 1);
+		bDelta = DeltaBit != 0;
+		if (bDelta)
+		{
+			SerializeSignedPacked(Ar, DeltaX);
+			SerializeSignedPacked(Ar, DeltaY);
+		}
+		else
+		{
+			Ar << X;
+			Ar << Y;
+		}
+
+		uint8 MovingBit = IsMoving() ? 1 : 0;
+		Ar.SerializeBits(&MovingBit, 1);
+		if (MovingBit)
+		{
+			SerializeSignedPacked(Ar, VelocityX);
+			SerializeSignedPacked(Ar, VelocityY);
+		}
+		else
+		{
+			VelocityX = 0;
+			VelocityY = 0;
+		}
+	}
+
+	bOutSuccess = true;
+	return true;
+}
+
+
+/** Bits SerializeIntPacked writes for Value: a byte per started 7 bits, at least one */
+static int32 GetPackedBits(const uint32 Value)
+{
+	const int32 ValueBits = 32 - FMath::CountLeadingZeros(Value);
+	return 8 * FMath::Max(1, FMath::DivideAndRoundUp(ValueBits, 7));
+}
+
+
+int32 FReplicatedCursorState::GetSerializedBits() const
+{
+	// Mirrors NetSerialize: the layout is fixed apart from the packed fields, so nothing needs to be written to count it
+	static const int32 HeaderBits = 8 * sizeof(Sequence) + 1;
+	static const int32 PositionBits = 8 * (sizeof(X) + sizeof(Y));
+
+	int32 Bits = HeaderBits;
+	if (bActive)
+	{
+		// Delta and moving flags
+		Bits += 2;
+		Bits += bDelta ? GetPackedBits(ZigZagEncode(DeltaX)) + GetPackedBits(ZigZagEncode(DeltaY)) : PositionBits;
+		if (IsMoving())
+		{
+			Bits += GetPackedBits(ZigZagEncode(VelocityX)) + GetPackedBits(ZigZagEncode(VelocityY));
+		}
+	}
+	return Bits;
+}
+
+
+UVirtualCursorReplicationComponent::UVirtualCursorReplicationComponent()
+	: MaxSendRate(30.0f)
+	, MinSendRate(5.0f)
+	, SpeedForMaxSendRate(1.0f)
+	, InterpolationDelay(0.1f)
+	, KeyframeInterval(0.5f)
+	, MaxExtrapolation(0.25f)
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	SetIsReplicatedByDefault(true);
+}
+
+
+void UVirtualCursorReplicationComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	// The owner has the real thing
+	DOREPLIFETIME_CONDITION(UVirtualCursorReplicationComponent, CursorState, COND_SkipOwner);
+}
+
+
+APlayerController* UVirtualCursorReplicationComponent::FindOwningController() const
+{
+	// PlayerState -> PlayerController, Pawn -> PlayerController, or the controller itself
+	for (AActor* Actor = GetOwner(); Actor; Actor = Actor->GetOwner())
+	{
+		if (APlayerController* PlayerController = Cast<APlayerController>(Actor))
+			return PlayerController;
+	}
+	return nullptr;
+}
+
+
+bool UVirtualCursorReplicationComponent::IsLocalCursor() const
+{
+	const APlayerController* PlayerController = FindOwningController();
+	return PlayerController && PlayerController->IsLocalController();
+}
+
+
+bool UVirtualCursorReplicationComponent::GetDisplayedCursor(FVector2D& ViewportPosition, FVector2D& ViewportVelocity) const
+{
+	ViewportPosition = DisplayedPosition;
+	ViewportVelocity = DisplayedVelocity;
+	return bDisplayed;
+}
+
+
+void UVirtualCursorReplicationComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	const double Time = FPlatformTime::Seconds();
+	if (IsLocalCursor())
+	{
+		UpdateLocalCursor(Time);
+	}
+	else
+	{
+		ReconstructRemoteCursor(Time);
+	}
+
+	if (Time - WindowStart >= 1.0)
+	{
+		BytesPerSecond = (WindowBits / 8.0f) / static_cast<float>(Time - WindowStart);
+		WindowBits = 0;
+		WindowStart = Time;
+	}
+}
+
+
+void UVirtualCursorReplicationComponent::UpdateLocalCursor(const double Time)
+{
+	const APlayerController* PlayerController = FindOwningController();
+	const ULocalPlayer* LocalPlayer = PlayerController ? PlayerController->GetLocalPlayer() : nullptr;
+	if (!LocalPlayer)
+		return;
+
+	// Controller ids restart at 0 in every PIE instance, so read the slot of this player's own cursor
+	const UVirtualCursorManager* Manager = LocalPlayer->GetSubsystem<UVirtualCursorManager>();
+	const TSharedPtr<FExtendedAnalogCursor> Cursor = Manager ? Manager->GetCursor() : nullptr;
+
+	FVirtualCursorSnapshot Snapshot;
+	bDisplayed = Cursor.IsValid() && FVirtualCursorStateBuffer::Get().Read(Cursor->GetStateSlot(), Snapshot) && Snapshot.bActive;
+	DisplayedPosition = Snapshot.ViewportPosition;
+	DisplayedVelocity = Snapshot.ViewportVelocity;
+
+	FReplicatedCursorState State;
+	State.bActive = bDisplayed;
+	if (bDisplayed)
+	{
+		State.Quantize(Snapshot.ViewportPosition, Snapshot.ViewportVelocity);
+	}
+
+	const double SinceLastSend = Time - LastSendTime;
+	if (State.Matches(LastSentState))
+	{
+		// Repeat a resting state once, since a lost one would leave remote cursors short of where this one stopped
+		if (State.IsMoving() || bRestingStateRepeated || SinceLastSend < 1.0 / MinSendRate)
+			return;
+
+		bRestingStateRepeated = true;
+	}
+	else
+	{
+		// Stopping, and enabling or disabling, go out at once. Anything else at a rate that follows the speed.
+		const bool bStopped = LastSentState.IsMoving() && !State.IsMoving();
+		if (!bStopped && State.bActive == LastSentState.bActive)
+		{
+			const float Travelled = (State.GetViewportPosition() - LastSentState.GetViewportPosition()).Size() / FMath::Max<float>(SinceLastSend, KINDA_SMALL_NUMBER);
+			const float Speed = FMath::Max<float>(Snapshot.ViewportVelocity.Size(), Travelled);
+			const float SendRate = FMath::Lerp(MinSendRate, FMath::Max<float>(MaxSendRate, MinSendRate), FMath::Clamp(Speed / SpeedForMaxSendRate, 0.0f, 1.0f));
+			if (SinceLastSend < 1.0 / SendRate)
+				return;
+		}
+
+		bRestingStateRepeated = false;
+	}
+
+	// The change from the last state usually packs into a byte or two per axis. A full position goes out regularly, whenever
+	// the last state had none, and for the repeated resting state, so the server can pick up again after a lost send.
+	if (State.bActive && LastSentState.bActive && !bRestingStateRepeated && Time - LastKeyframeTime < KeyframeInterval)
+	{
+		State.SetDeltaBase(LastSentState);
+	}
+	else
+	{
+		LastKeyframeTime = Time;
+	}
+
+	State.Sequence = LastSentState.Sequence + 1;
+	LastSentState = State;
+	LastSendTime = Time;
+	CountBits(State.GetSerializedBits());
+
+	if (GetOwnerRole() == ROLE_Authority)
+	{
+		CursorState = State;
+		GetOwner()->ForceNetUpdate();
+	}
+	else
+	{
+		ServerSetCursorState(State);
+	}
+}
+
+
+void UVirtualCursorReplicationComponent::ServerSetCursorState_Implementation(const FReplicatedCursorState& NewState)
+{
+	// Unreliable, so a late state may arrive after a newer one
+	if (static_cast<int8>(NewState.Sequence - CursorState.Sequence) <= 0 && CursorState.Sequence != 0)
+		return;
+
+	// A delta whose base was lost can't be placed. The next full position is at most KeyframeInterval away.
+	FReplicatedCursorState Resolved = NewState;
+	if (!Resolved.ResolveDelta(CursorState))
+		return;
+
+	// Stored with its full position, since each connection may have missed different states
+	CursorState = Resolved;
+
+	// Owners such as the PlayerState only consider replicating once a second by default
+	GetOwner()->ForceNetUpdate();
+
+	// A listen server shows remote cursors too, but doesn't get OnRep
+	if (GetNetMode() == NM_ListenServer)
+	{
+		CountBits(NewState.GetSerializedBits());
+		ReceiveState(Resolved, FPlatformTime::Seconds());
+	}
+}
+
+
+void UVirtualCursorReplicationComponent::OnRep_CursorState()
+{
+	CountBits(CursorState.GetSerializedBits());
+	ReceiveState(CursorState, FPlatformTime::Seconds());
+}
+
+
+void UVirtualCursorReplicationComponent::ReceiveState(const FReplicatedCursorState& State, const double Time)
+{
+	// Older than what was already queued, e.g. a late RPC on a listen server
+	if (ReceivedHead != INDEX_NONE && static_cast<int8>(State.Sequence - LastReceivedSequence) <= 0)
+		return;
+
+	LastReceivedSequence = State.Sequence;
+
+	// A cursor that starts moving after resting interpolates over one send interval, not the whole rest
+	if (ReceivedHead != INDEX_NONE)
+	{
+		const FReceivedState& Previous = ReceivedHistory[ReceivedHead];
+		const double SendInterval = 1.0 / FMath::Max<float>(MaxSendRate, 1.0f);
+		if (Previous.Velocity.IsZero() && Time - Previous.Time > SendInterval)
+		{
+			FReceivedState Restamped = Previous;
+			Restamped.Time = Time - SendInterval;
+			ReceivedHead = (ReceivedHead + 1) % ReceivedHistorySize;
+			ReceivedHistory[ReceivedHead] = Restamped;
+		}
+	}
+
+	FReceivedState Entry;
+	Entry.Time = Time;
+	Entry.Position = State.GetViewportPosition();
+	Entry.Velocity = State.GetViewportVelocity();
+	Entry.bActive = State.bActive;
+
+	ReceivedHead = (ReceivedHead + 1) % ReceivedHistorySize;
+	ReceivedHistory[ReceivedHead] = Entry;
+}
+
+
+void UVirtualCursorReplicationComponent::ReconstructRemoteCursor(const double Time)
+{
+	bDisplayed = false;
+	if (ReceivedHead == INDEX_NONE)
+		return;
+
+	// Walk from newest to oldest for the states around the render time
+	const double RenderTime = Time - InterpolationDelay;
+	const FReceivedState* Before = nullptr;
+	const FReceivedState* After = nullptr;
+	for (int32 i = 0; i < ReceivedHistorySize; ++i)
+	{
+		const FReceivedState& Entry = ReceivedHistory[(ReceivedHead - i + ReceivedHistorySize) % ReceivedHistorySize];
+		if (Entry.Time <= 0.0)
+			break;
+
+		if (Entry.Time <= RenderTime)
+		{
+			Before = &Entry;
+			break;
+		}
+		After = &Entry;
+	}
+
+	// Everything we have is newer than the render time: hold the oldest
+	if (!Before)
+	{
+		Before = After;
+		After = nullptr;
+	}
+	if (!Before || !Before->bActive)
+		return;
+
+	if (After && After->bActive)
+	{
+		// Cubic Hermite between the two states, with their velocities as tangents
+		const float Span = static_cast<float>(After->Time - Before->Time);
+		const float Alpha = FMath::Clamp(static_cast<float>(RenderTime - Before->Time) / FMath::Max<float>(Span, KINDA_SMALL_NUMBER), 0.0f, 1.0f);
+		DisplayedPosition = FMath::CubicInterp(Before->Position, Before->Velocity * Span, After->Position, After->Velocity * Span, Alpha);
+		DisplayedVelocity = FMath::Lerp(Before->Velocity, After->Velocity, Alpha);
+	}
+	else
+	{
+		// The next state is late: carry on along the last velocity for a while, then wait
+		const float Ahead = FMath::Clamp(static_cast<float>(RenderTime - Before->Time), 0.0f, MaxExtrapolation);
+		DisplayedPosition = Before->Position + (Before->Velocity * Ahead);
+		DisplayedVelocity = Ahead < MaxExtrapolation ? Before->Velocity : FVector2D::ZeroVector;
+	}
+
+	DisplayedPosition.X = FMath::Clamp(DisplayedPosition.X, 0.0f, 1.0f);
+	DisplayedPosition.Y = FMath::Clamp(DisplayedPosition.Y, 0.0f, 1.0f);
+	bDisplayed = true;
+}
+
+
+void UVirtualCursorReplicationComponent::CountBits(const int32 Bits)
+{
+	WindowBits += Bits;
+}
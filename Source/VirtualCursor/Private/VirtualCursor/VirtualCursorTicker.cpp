@@ -0,0 +1,276 @@
+#include "VirtualCursor/VirtualCursorTicker.h"
+#include "VirtualCursor/VirtualCursorManager.h"
+#include "VirtualCursor/CursorSettings.h"
+#include "VirtualCursor/CursorFrameBudget.h"
+#include "VirtualCursor/ExtendedAnalogCursor.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Framework/Application/SlateApplication.h"
+
+
+/** HoverResults entry for a cursor the snapshot can't answer for, see FCursorHitTestSnapshot::NeedsSerialHitTest */
+static const int32 SerialHoverResult = -2;
+
+
+void FVirtualCursorTicker::RegisterManager(UVirtualCursorManager* Manager)
+{
+	Managers.AddUnique(Manager);
+}
+
+
+void FVirtualCursorTicker::UnregisterManager(UVirtualCursorManager* Manager)
+{
+	Managers.Remove(Manager);
+}
+
+
+void FVirtualCursorTicker::UpdateCursorRadius()
+{
+	if (!FSlateApplication::IsInitialized())
+		return;
+
+	float MaxRadius = 0.0f;
+	for (const TWeakObjectPtr<UVirtualCursorManager>& Manager : Managers)
+	{
+		if (Manager.IsValid() && Manager->ContainsGamepadCursorInputProcessor())
+		{
+			MaxRadius = FMath::Max(MaxRadius, Manager->GetCursor()->GetRequestedCursorRadius());
+		}
+	}
+	FSlateApplication::Get().SetCursorRadius(MaxRadius);
+}
+
+
+void FVirtualCursorTicker::Tick(const float DeltaTime)
+{
+	Managers.RemoveAll([](const TWeakObjectPtr<UVirtualCursorManager>& Manager) { return !Manager.IsValid(); });
+
+	// Consume last frame's results before issuing new requests, so no manager has two traces in flight
+	for (const TWeakObjectPtr<UVirtualCursorManager>& Manager : Managers)
+	{
+		Manager->ConsumeWorldPick();
+	}
+
+	// Optional work, deferred round robin when the cursors are over their frame budget.
+	// Ray/quad tests against world widgets run before, and can stand in for, the physics traces.
+	FVirtualCursorFrameBudget& FrameBudget = FVirtualCursorFrameBudget::Get();
+	for (const TWeakObjectPtr<UVirtualCursorManager>& Manager : Managers)
+	{
+		const int32 StateSlot = Manager->IsCursorValid() ? Manager->GetCursor()->GetStateSlot() : INDEX_NONE;
+		if (!FrameBudget.TryBegin(ECursorWorkPriority::Optional, StateSlot))
+			continue;
+
+		const uint32 StartCycles = FPlatformTime::Cycles();
+		Manager->UpdateCursorRay();
+		Manager->UpdateWorldWidgetHover();
+		Manager->RequestWorldPick();
+		FrameBudget.Charge(ECursorWorkPriority::Optional, FPlatformTime::Cycles() - StartCycles);
+	}
+
+	// Heatmaps integrate time, so skipping frames would skew them. It's a single cell update per player.
+	const uint32 HeatmapStartCycles = FPlatformTime::Cycles();
+	for (const TWeakObjectPtr<UVirtualCursorManager>& Manager : Managers)
+	{
+		Manager->AccumulateHeatmap(DeltaTime);
+	}
+	FrameBudget.Charge(ECursorWorkPriority::Optional, FPlatformTime::Cycles() - HeatmapStartCycles);
+
+	// Runs before Slate ticks the cursors, which then pick the results up instead of hit testing themselves
+	bool bSnapshotIsFresh = false;
+	if (GetDefault<UCursorSettings>()->GetResolveHoverInParallel())
+	{
+		const uint32 StartCycles = FPlatformTime::Cycles();
+		bSnapshotIsFresh = ResolveHoverInParallel();
+		FrameBudget.Charge(ECursorWorkPriority::Hover, FPlatformTime::Cycles() - StartCycles);
+	}
+
+	const uint32 MagnetismStartCycles = FPlatformTime::Cycles();
+	UpdateMagnetismFields(bSnapshotIsFresh);
+	FrameBudget.Charge(ECursorWorkPriority::Optional, FPlatformTime::Cycles() - MagnetismStartCycles);
+
+	if (GetDefault<UCursorSettings>()->GetPrefetchHoverAssets())
+	{
+		const uint32 PrefetchStartCycles = FPlatformTime::Cycles();
+		UpdateHoverPrefetch();
+		FrameBudget.Charge(ECursorWorkPriority::Optional, FPlatformTime::Cycles() - PrefetchStartCycles);
+	}
+}
+
+
+bool FVirtualCursorTicker::ResolveHoverInParallel()
+{
+	if (!FSlateApplication::IsInitialized())
+		return false;
+
+	HoverCursors.Reset();
+	HoverPositions.Reset();
+	for (const TWeakObjectPtr<UVirtualCursorManager>& Manager : Managers)
+	{
+		if (Manager->ContainsGamepadCursorInputProcessor())
+		{
+			HoverCursors.Add(Manager->GetCursor());
+			HoverPositions.Add(Manager->GetCursor()->GetCurrentPosition());
+		}
+	}
+	if (HoverCursors.Num() == 0)
+		return false;
+
+	FSlateApplication& SlateApp = FSlateApplication::Get();
+	HitTestSnapshot.Build(SlateApp);
+	LastSnapshotTime = FPlatformTime::Seconds();
+
+	// The snapshot is immutable from here on, so the queries can run side by side
+	const float CursorRadius = SlateApp.GetCursorRadius();
+	HoverResults.SetNum(HoverCursors.Num(), false);
+	HoverLayouts.SetNum(HoverCursors.Num(), false);
+	ParallelFor(HoverCursors.Num(), [this, CursorRadius](const int32 Index)
+	{
+		HoverResults[Index] = HitTestSnapshot.NeedsSerialHitTest(HoverPositions[Index], CursorRadius)
+			? SerialHoverResult
+			: HitTestSnapshot.FindInteractable(HoverPositions[Index], CursorRadius, HoverLayouts[Index]);
+	});
+
+	FCursorHoverResult Result;
+	for (int32 Index = 0; Index < HoverCursors.Num(); ++Index)
+	{
+		// Without a precomputed result the cursor hit tests through Slate itself
+		if (HoverResults[Index] == SerialHoverResult)
+			continue;
+
+		HitTestSnapshot.GetHoverResult(HoverResults[Index], HoverLayouts[Index], Result);
+		HoverCursors[Index]->SetPrecomputedHover(HoverPositions[Index], Result);
+	}
+
+	// Don't keep the cursors alive until next frame
+	HoverCursors.Reset();
+	return true;
+}
+
+
+void FVirtualCursorTicker::UpdateMagnetismFields(const bool bSnapshotIsFresh)
+{
+	if (MagnetismBuild.IsValid())
+	{
+		if (!MagnetismBuild.IsReady())
+			return;
+
+		const TArray<FMagnetismFieldPtr>& Fields = MagnetismBuild.Get();
+		for (int32 Index = 0; Index < MagnetismBuildCursors.Num(); ++Index)
+		{
+			if (TSharedPtr<FExtendedAnalogCursor> Cursor = MagnetismBuildCursors[Index].Pin())
+			{
+				Cursor->SetMagnetismField(Fields[Index]);
+			}
+		}
+		MagnetismBuild.Reset();
+		MagnetismBuildCursors.Reset();
+	}
+
+	if (!FSlateApplication::IsInitialized())
+		return;
+
+	TArray<TSharedPtr<FExtendedAnalogCursor>> Cursors;
+	for (const TWeakObjectPtr<UVirtualCursorManager>& Manager : Managers)
+	{
+		if (Manager->IsCursorValid() && Manager->GetCursor()->IsMagnetismEnabled())
+		{
+			Cursors.Add(Manager->GetCursor());
+		}
+	}
+	if (Cursors.Num() == 0)
+	{
+		MagnetismInputHash = 0;
+		return;
+	}
+
+	// Walking the widget tree is the only game thread cost, so don't do it every frame just for magnetism
+	const double Now = FPlatformTime::Seconds();
+	if (!bSnapshotIsFresh && Now - LastMagnetismCheckTime < MagnetismCheckInterval)
+		return;
+
+	// Cursors keep their current field while the rebuild is deferred
+	if (!FVirtualCursorFrameBudget::Get().TryBegin(ECursorWorkPriority::Optional, FVirtualCursorFrameBudget::SharedWork))
+		return;
+
+	if (!bSnapshotIsFresh)
+	{
+		HitTestSnapshot.Build(FSlateApplication::Get());
+		LastSnapshotTime = Now;
+	}
+	LastMagnetismCheckTime = Now;
+
+	const TArray<FSlateRect>& Rects = HitTestSnapshot.GetInteractableRects();
+	uint32 Hash = FCrc::MemCrc32(Rects.GetData(), Rects.Num() * Rects.GetTypeSize());
+
+	TArray<FSlateRect> ViewportBounds;
+	TArray<float> Radii;
+	for (const TSharedPtr<FExtendedAnalogCursor>& Cursor : Cursors)
+	{
+		FGeometry ViewportGeometry;
+		FSlateRect Bounds(0.0f, 0.0f, 0.0f, 0.0f);
+		if (Cursor->GetPlayerViewportGeometry(ViewportGeometry))
+		{
+			Bounds = FSlateRect(ViewportGeometry.LocalToAbsolute(FVector2D::ZeroVector), ViewportGeometry.LocalToAbsolute(ViewportGeometry.GetLocalSize()));
+		}
+		ViewportBounds.Add(Bounds);
+		Radii.Add(Cursor->GetMagnetismRadius());
+
+		Hash = FCrc::MemCrc32(&Bounds, sizeof(Bounds), Hash);
+		Hash = HashCombine(Hash, GetTypeHash(Radii.Last()));
+		Hash = HashCombine(Hash, GetTypeHash(Cursor.Get()));
+	}
+	if (Hash == MagnetismInputHash)
+		return;
+
+	MagnetismInputHash = Hash;
+	MagnetismBuildCursors.Reset();
+	for (const TSharedPtr<FExtendedAnalogCursor>& Cursor : Cursors)
+	{
+		MagnetismBuildCursors.Add(Cursor);
+	}
+
+	// Everything the worker reads is copied into the task, so the snapshot can be rebuilt meanwhile
+	const float CellSize = GetDefault<UCursorSettings>()->GetMagnetismCellSize();
+	MagnetismBuild = Async(EAsyncExecution::ThreadPool, [Rects = Rects, ViewportBounds = MoveTemp(ViewportBounds), Radii = MoveTemp(Radii), CellSize]()
+	{
+		TArray<FMagnetismFieldPtr> Fields;
+		for (int32 Index = 0; Index < ViewportBounds.Num(); ++Index)
+		{
+			TSharedRef<FCursorMagnetismField, ESPMode::ThreadSafe> Field = MakeShared<FCursorMagnetismField, ESPMode::ThreadSafe>();
+			Field->Build(ViewportBounds[Index], Rects, Radii[Index], CellSize);
+			Fields.Add(Field);
+		}
+		return Fields;
+	});
+}
+
+
+void FVirtualCursorTicker::UpdateHoverPrefetch()
+{
+	if (!FSlateApplication::IsInitialized())
+		return;
+
+	if (!FVirtualCursorFrameBudget::Get().TryBegin(ECursorWorkPriority::Optional, FVirtualCursorFrameBudget::SharedWork))
+		return;
+
+	const double Now = FPlatformTime::Seconds();
+	if (Now - LastSnapshotTime >= PrefetchSnapshotMaxAge)
+	{
+		HitTestSnapshot.Build(FSlateApplication::Get());
+		LastSnapshotTime = Now;
+	}
+
+	HoverPrefetcher.Update(Managers, HitTestSnapshot, GetDefault<UCursorSettings>()->GetHoverPrefetchHorizon());
+}
+
+
+bool FVirtualCursorTicker::IsTickable() const
+{
+	return Managers.Num() > 0;
+}
+
+
+TStatId FVirtualCursorTicker::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FVirtualCursorTicker, STATGROUP_Tickables);
+}
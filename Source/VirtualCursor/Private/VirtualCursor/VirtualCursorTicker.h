@@ -0,0 +1,100 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "Async/Future.h"
+#include "VirtualCursor/CursorHitTestSnapshot.h"
+#include "VirtualCursor/CursorHoverPrefetch.h"
+#include "VirtualCursor/CursorMagnetismField.h"
+
+class FExtendedAnalogCursor;
+class UVirtualCursorManager;
+
+
+/**
+ * Ticks the optional per-frame features of every virtual cursor manager in one place,
+ * so work such as world picks can be batched across all local players (and all worlds).
+ * Owned by FVirtualCursorPlugin.
+ */
+class FVirtualCursorTicker : public FTickableGameObject
+{
+public:
+
+	void RegisterManager(UVirtualCursorManager* Manager);
+
+	void UnregisterManager(UVirtualCursorManager* Manager);
+
+	FORCEINLINE const TArray<TWeakObjectPtr<UVirtualCursorManager>>& GetManagers() const
+	{
+		return Managers;
+	}
+
+	/**
+	* Sets Slate's cursor radius to the largest one requested by any enabled cursor, in any world.
+	* Called whenever a cursor's request changes or a cursor is unregistered from Slate.
+	*/
+	void UpdateCursorRadius();
+
+	FORCEINLINE FCursorHoverPrefetcher& GetHoverPrefetcher()
+	{
+		return HoverPrefetcher;
+	}
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual bool IsTickableWhenPaused() const override { return true; }
+	virtual bool IsTickableInEditor() const override { return false; }
+	virtual TStatId GetStatId() const override;
+
+private:
+
+	/** Snapshots the widget geometry and resolves every enabled cursor's hover with ParallelFor. Returns true if it built HitTestSnapshot. */
+	bool ResolveHoverInParallel();
+
+	/**
+	* Hands finished magnetism fields to their cursors, and starts rebuilding them on a worker thread when the interactable layout
+	* or a viewport changed. Reuses this frame's snapshot if there is one, otherwise takes its own at most every MagnetismCheckInterval.
+	* The check and rebuild are optional work under the frame budget; handing finished fields over is not.
+	*/
+	void UpdateMagnetismFields(bool bSnapshotIsFresh);
+
+	/** 
+	* Predicts the widgets moving cursors are about to hover, if enabled. Rebuilds the snapshot if nothing else did recently.
+	* Skipped entirely on frames the frame budget defers it.
+	*/
+	void UpdateHoverPrefetch();
+
+	/** Seconds between layout checks while no snapshot is built for parallel hover anyway */
+	static constexpr double MagnetismCheckInterval = 0.1;
+
+	/** Oldest snapshot hover prediction still runs against */
+	static constexpr double PrefetchSnapshotMaxAge = 0.1;
+
+	TArray<TWeakObjectPtr<UVirtualCursorManager>> Managers;
+
+	FCursorHitTestSnapshot HitTestSnapshot;
+
+	/** When HitTestSnapshot was last built */
+	double LastSnapshotTime = 0.0;
+
+	FCursorHoverPrefetcher HoverPrefetcher;
+
+	/** Scratch arrays for ResolveHoverInParallel, kept to avoid allocating every frame */
+	TArray<TSharedPtr<FExtendedAnalogCursor>> HoverCursors;
+	TArray<FVector2D> HoverPositions;
+	TArray<int32> HoverResults;
+	TArray<FName> HoverLayouts;
+
+	typedef TSharedPtr<const FCursorMagnetismField, ESPMode::ThreadSafe> FMagnetismFieldPtr;
+
+	/** The fields being built, in the order of MagnetismBuildCursors */
+	TFuture<TArray<FMagnetismFieldPtr>> MagnetismBuild;
+
+	TArray<TWeakPtr<FExtendedAnalogCursor>> MagnetismBuildCursors;
+
+	/** Hash of the rects, viewports and radii the last build was started from */
+	uint32 MagnetismInputHash = 0;
+
+	double LastMagnetismCheckTime = 0.0;
+};
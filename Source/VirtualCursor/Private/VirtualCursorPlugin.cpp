@@ -1,5 +1,21 @@
 
 #include "VirtualCursorPlugin.h"
+#include "VirtualCursor/CursorTelemetry.h"
+#include "VirtualCursor/ExtendedAnalogCursor.h"
+#include "VirtualCursor/VirtualCursorTicker.h"
+#include "VirtualCursor/VirtualCursorOverlay.h"
+#include "VirtualCursor/VirtualCursorDebugOverlay.h"
+#include "VirtualCursor/VirtualCursorManager.h"
+#include "VirtualCursor/CursorLoadingTick.h"
+#include "VirtualCursor/CursorSettings.h"
+#include "VirtualCursor/CursorKeyBindings.h"
+#include "GameFramework/InputSettings.h"
+#include "MoviePlayer.h"
+#include "UObject/UObjectGlobals.h"
+#include "Engine/GameInstance.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/World.h"
 
 DEFINE_LOG_CATEGORY(LogVirtualCursor);
 
@@ -9,15 +25,266 @@ DEFINE_LOG_CATEGORY(LogVirtualCursor);
 
 void FVirtualCursorPlugin::StartupModule()
 {
+	Ticker = MakeShared<FVirtualCursorTicker>();
+	LoadingTick = MakeShared<FVirtualCursorLoadingTick>();
+
+	PreLoadMapHandle = FCoreUObjectDelegates::PreLoadMap.AddRaw(this, &FVirtualCursorPlugin::HandlePreLoadMap);
+	PostLoadMapHandle = FCoreUObjectDelegates::PostLoadMapWithWorld.AddRaw(this, &FVirtualCursorPlugin::HandlePostLoadMapWithWorld);
+	WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddRaw(this, &FVirtualCursorPlugin::HandleWorldCleanup);
+	if (IGameMoviePlayer* MoviePlayer = GetMoviePlayer())
+	{
+		PrepareLoadingScreenHandle = MoviePlayer->OnPrepareLoadingScreen().AddRaw(this, &FVirtualCursorPlugin::BeginLoadingTick);
+		MoviePlaybackFinishedHandle = MoviePlayer->OnMoviePlaybackFinished().AddRaw(this, &FVirtualCursorPlugin::EndLoadingTick);
+	}
+#if WITH_EDITOR
+	ObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddRaw(this, &FVirtualCursorPlugin::HandleObjectPropertyChanged);
+#endif
+
 	UE_LOG(LogVirtualCursor, Log, TEXT("VirtualCursor module has started"));
 }
 
 
 void FVirtualCursorPlugin::ShutdownModule()
 {
+	FCoreUObjectDelegates::PreLoadMap.Remove(PreLoadMapHandle);
+	FCoreUObjectDelegates::PostLoadMapWithWorld.Remove(PostLoadMapHandle);
+	FWorldDelegates::OnWorldCleanup.Remove(WorldCleanupHandle);
+	if (IGameMoviePlayer* MoviePlayer = GetMoviePlayer())
+	{
+		MoviePlayer->OnPrepareLoadingScreen().Remove(PrepareLoadingScreenHandle);
+		MoviePlayer->OnMoviePlaybackFinished().Remove(MoviePlaybackFinishedHandle);
+	}
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(ObjectPropertyChangedHandle);
+#endif
+
+	EndLoadingTick();
+	LoadingTick.Reset();
+	FVirtualCursorTelemetry::End();
+	ClearParkedCursors();
+	for (const FCursorOverlay& Overlay : CursorOverlays)
+	{
+		if (Overlay.bShown && Overlay.ViewportClient.IsValid())
+		{
+			Overlay.ViewportClient->RemoveViewportWidgetContent(Overlay.Widget.ToSharedRef());
+		}
+	}
+	CursorOverlays.Empty();
+	for (const FDebugOverlay& Overlay : DebugOverlays)
+	{
+		if (Overlay.ViewportClient.IsValid())
+		{
+			Overlay.ViewportClient->RemoveViewportWidgetContent(Overlay.Widget.ToSharedRef());
+		}
+	}
+	DebugOverlays.Empty();
+	Ticker.Reset();
 	UE_LOG(LogVirtualCursor, Log, TEXT("VirtualCursor module has shut down"));
 }
 
+
+void FVirtualCursorPlugin::ParkCursor(const UGameInstance* GameInstance, const int32 ControllerId, const TSharedPtr<FExtendedAnalogCursor>& Cursor, const bool bWasEnabled)
+{
+	if (!GameInstance || !Cursor.IsValid())
+		return;
+
+	// A parked cursor is not drawn, so it must not keep the Slate cursor radius up for the players that are
+	Cursor->RequestCursorRadius(0.0f);
+
+	FParkedCursor* Parked = ParkedCursors.FindByPredicate([GameInstance, ControllerId](const FParkedCursor& Candidate)
+	{
+		return Candidate.GameInstance == GameInstance && Candidate.ControllerId == ControllerId;
+	});
+	if (!Parked)
+	{
+		Parked = &ParkedCursors.AddDefaulted_GetRef();
+		Parked->GameInstance = GameInstance;
+		Parked->ControllerId = ControllerId;
+	}
+	Parked->Cursor = Cursor;
+	Parked->bWasEnabled = bWasEnabled;
+}
+
+
+TSharedPtr<FExtendedAnalogCursor> FVirtualCursorPlugin::ClaimParkedCursor(const UGameInstance* GameInstance, const int32 ControllerId, bool& bOutWasEnabled)
+{
+	const int32 Index = ParkedCursors.IndexOfByPredicate([GameInstance, ControllerId](const FParkedCursor& Candidate)
+	{
+		return Candidate.GameInstance == GameInstance && Candidate.ControllerId == ControllerId;
+	});
+	if (GameInstance && Index != INDEX_NONE)
+	{
+		const FParkedCursor Parked = ParkedCursors[Index];
+		ParkedCursors.RemoveAtSwap(Index);
+		bOutWasEnabled = Parked.bWasEnabled;
+		return Parked.Cursor;
+	}
+
+	bOutWasEnabled = false;
+	return nullptr;
+}
+
+
+void FVirtualCursorPlugin::ClearParkedCursors()
+{
+	ParkedCursors.Empty();
+}
+
+
+void FVirtualCursorPlugin::ShowCursorOverlay(UGameViewportClient* ViewportClient, const int32 ZOrder)
+{
+	if (!ViewportClient)
+		return;
+
+	HideCursorOverlay(ViewportClient);
+	FCursorOverlay& Overlay = FindOrAddCursorOverlay(ViewportClient);
+	ViewportClient->AddViewportWidgetContent(Overlay.Widget.ToSharedRef(), ZOrder);
+	Overlay.bShown = true;
+}
+
+
+void FVirtualCursorPlugin::HideCursorOverlay(UGameViewportClient* ViewportClient)
+{
+	FCursorOverlay* Overlay = CursorOverlays.FindByPredicate([ViewportClient](const FCursorOverlay& Candidate) { return Candidate.ViewportClient == ViewportClient; });
+	if (Overlay && Overlay->bShown && ViewportClient)
+	{
+		ViewportClient->RemoveViewportWidgetContent(Overlay->Widget.ToSharedRef());
+		Overlay->bShown = false;
+	}
+}
+
+
+void FVirtualCursorPlugin::RefreshDebugOverlay(UGameViewportClient* ViewportClient)
+{
+#if WITH_VIRTUALCURSOR_DEBUG
+	if (!ViewportClient)
+		return;
+
+	// The viewport clients of ended PIE sessions took their overlays with them
+	DebugOverlays.RemoveAll([](const FDebugOverlay& Overlay) { return !Overlay.ViewportClient.IsValid(); });
+
+	// Only this viewport's own players count, other PIE instances debug in their own windows
+	bool bAnyDebugging = false;
+	if (const UGameInstance* GameInstance = ViewportClient->GetGameInstance())
+	{
+		for (ULocalPlayer* LocalPlayer : GameInstance->GetLocalPlayers())
+		{
+			const UVirtualCursorManager* Manager = LocalPlayer ? LocalPlayer->GetSubsystem<UVirtualCursorManager>() : nullptr;
+			bAnyDebugging |= Manager && (Manager->IsCursorDebugActive() || Manager->IsAnalogDebugActive());
+		}
+	}
+
+	const int32 Index = DebugOverlays.IndexOfByPredicate([ViewportClient](const FDebugOverlay& Candidate) { return Candidate.ViewportClient == ViewportClient; });
+	if (bAnyDebugging && Index == INDEX_NONE)
+	{
+		FDebugOverlay& Overlay = DebugOverlays.AddDefaulted_GetRef();
+		Overlay.ViewportClient = ViewportClient;
+		Overlay.Widget = SNew(SVirtualCursorDebugOverlay).ViewportClient(ViewportClient);
+
+		// Above the game's own widgets and the cursor overlay
+		ViewportClient->AddViewportWidgetContent(Overlay.Widget.ToSharedRef(), 10000);
+	}
+	else if (!bAnyDebugging && Index != INDEX_NONE)
+	{
+		ViewportClient->RemoveViewportWidgetContent(DebugOverlays[Index].Widget.ToSharedRef());
+		DebugOverlays.RemoveAtSwap(Index);
+	}
+#endif
+}
+
+
+TSharedRef<SWidget> FVirtualCursorPlugin::MakeCursorOverlay() const
+{
+	return SNew(SVirtualCursorOverlay);
+}
+
+
+void FVirtualCursorPlugin::BeginLoadingTick()
+{
+	if (!LoadingTick.IsValid() || !Ticker.IsValid() || !GetDefault<UCursorSettings>()->GetTickDuringLoads())
+		return;
+
+	TArray<TSharedPtr<FExtendedAnalogCursor>> Cursors;
+	for (const TWeakObjectPtr<UVirtualCursorManager>& Manager : Ticker->GetManagers())
+	{
+		if (Manager.IsValid() && Manager->ContainsGamepadCursorInputProcessor())
+		{
+			Cursors.Add(Manager->GetCursor());
+		}
+	}
+	LoadingTick->Begin(Cursors);
+}
+
+
+void FVirtualCursorPlugin::EndLoadingTick()
+{
+	if (LoadingTick.IsValid())
+	{
+		LoadingTick->End();
+	}
+}
+
+
+void FVirtualCursorPlugin::HandleWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources)
+{
+	// A game instance shutting down removes its local players, whose managers park their cursors, before its world is cleaned up
+	const UGameInstance* WorldGameInstance = World ? World->GetGameInstance() : nullptr;
+	ParkedCursors.RemoveAll([WorldGameInstance](const FParkedCursor& Parked)
+	{
+		return !Parked.GameInstance.IsValid() || (Parked.GameInstance == WorldGameInstance && WorldGameInstance->GetNumLocalPlayers() == 0);
+	});
+}
+
+
+void FVirtualCursorPlugin::HandlePreLoadMap(const FString& MapName)
+{
+	BeginLoadingTick();
+}
+
+
+void FVirtualCursorPlugin::HandlePostLoadMapWithWorld(UWorld* LoadedWorld)
+{
+	// A loading screen keeps the cursors until its movie finishes
+	IGameMoviePlayer* MoviePlayer = GetMoviePlayer();
+	if (!MoviePlayer || !MoviePlayer->IsMovieCurrentlyPlaying())
+	{
+		EndLoadingTick();
+	}
+}
+
+
+#if WITH_EDITOR
+void FVirtualCursorPlugin::HandleObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	if (Object && Object->IsA<UInputSettings>())
+	{
+		FCursorKeyBindings::Invalidate();
+	}
+}
+#endif
+
+
+SVirtualCursorOverlay& FVirtualCursorPlugin::GetCursorOverlay(UGameViewportClient* ViewportClient)
+{
+	return *FindOrAddCursorOverlay(ViewportClient).Widget;
+}
+
+
+FVirtualCursorPlugin::FCursorOverlay& FVirtualCursorPlugin::FindOrAddCursorOverlay(UGameViewportClient* ViewportClient)
+{
+	// The viewport clients of ended PIE sessions took their overlays with them
+	CursorOverlays.RemoveAll([](const FCursorOverlay& Overlay) { return !Overlay.ViewportClient.IsValid(); });
+
+	FCursorOverlay* Overlay = CursorOverlays.FindByPredicate([ViewportClient](const FCursorOverlay& Candidate) { return Candidate.ViewportClient == ViewportClient; });
+	if (!Overlay)
+	{
+		Overlay = &CursorOverlays.AddDefaulted_GetRef();
+		Overlay->ViewportClient = ViewportClient;
+		Overlay->Widget = SNew(SVirtualCursorOverlay).ViewportClient(ViewportClient);
+	}
+	return *Overlay;
+}
+
 #undef LOCTEXT_NAMESPACE
 
 IMPLEMENT_MODULE(FVirtualCursorPlugin, VirtualCursor)
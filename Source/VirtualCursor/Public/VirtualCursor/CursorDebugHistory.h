@@ -0,0 +1,120 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Layout/SlateRect.h"
+
+
+/** Cursor debugging is compiled out of shipping builds, along with the overlay that shows it */
+#ifndef WITH_VIRTUALCURSOR_DEBUG
+#define WITH_VIRTUALCURSOR_DEBUG !UE_BUILD_SHIPPING
+#endif
+
+
+enum class ECursorDebugInput : uint8
+{
+	Pressed,
+	Held,
+	Released,
+	Analog
+};
+
+
+#if WITH_VIRTUALCURSOR_DEBUG
+
+
+/** One input event seen by a cursor while debugging */
+struct FCursorDebugInput
+{
+	FName Key;
+	float Value = 0.0f;
+	double Time = 0.0;
+	ECursorDebugInput Kind = ECursorDebugInput::Pressed;
+};
+
+
+/** What a cursor's Tick computed on one frame while debugging, all in absolute coordinates */
+struct FCursorDebugFrame
+{
+	FVector2D Position = FVector2D::ZeroVector;
+	FVector2D Velocity = FVector2D::ZeroVector;
+
+	/** Area the cursor's center is clamped to */
+	FSlateRect ClampBounds;
+
+	/** Bounds of the hovered widget, only meaningful if bHovered */
+	FSlateRect HoveredRect;
+
+	bool bHovered = false;
+
+	/** True if GetAbsoluteClampedPosition moved the cursor this frame */
+	bool bClamped = false;
+};
+
+
+/** Fixed-size rings of a cursor's latest debug frames and input. Nothing is allocated after construction. */
+class FCursorDebugHistory
+{
+public:
+
+	static constexpr int32 NumFrames = 32;
+
+	static constexpr int32 NumInputs = 8;
+
+	FORCEINLINE void AddFrame(const FCursorDebugFrame& Frame)
+	{
+		FrameHead = (FrameHead + 1) % NumFrames;
+		Frames[FrameHead] = Frame;
+		NumFramesAdded = FMath::Min(NumFramesAdded + 1, NumFrames);
+	}
+
+	FORCEINLINE void AddInput(const FName Key, const ECursorDebugInput Kind, const float Value)
+	{
+		InputHead = (InputHead + 1) % NumInputs;
+		FCursorDebugInput& Input = Inputs[InputHead];
+		Input.Key = Key;
+		Input.Kind = Kind;
+		Input.Value = Value;
+		Input.Time = FPlatformTime::Seconds();
+		NumInputsAdded = FMath::Min(NumInputsAdded + 1, NumInputs);
+	}
+
+	FORCEINLINE int32 GetNumFrames() const
+	{
+		return NumFramesAdded;
+	}
+
+	FORCEINLINE int32 GetNumInputs() const
+	{
+		return NumInputsAdded;
+	}
+
+	/** Age 0 is the newest */
+	FORCEINLINE const FCursorDebugFrame& GetFrame(const int32 Age) const
+	{
+		return Frames[(FrameHead - Age + NumFrames) % NumFrames];
+	}
+
+	/** Age 0 is the newest */
+	FORCEINLINE const FCursorDebugInput& GetInput(const int32 Age) const
+	{
+		return Inputs[(InputHead - Age + NumInputs) % NumInputs];
+	}
+
+	void Reset()
+	{
+		NumFramesAdded = 0;
+		NumInputsAdded = 0;
+	}
+
+private:
+
+	FCursorDebugFrame Frames[NumFrames];
+	FCursorDebugInput Inputs[NumInputs];
+
+	int32 FrameHead = 0;
+	int32 InputHead = 0;
+	int32 NumFramesAdded = 0;
+	int32 NumInputsAdded = 0;
+};
+
+#endif // WITH_VIRTUALCURSOR_DEBUG
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "VirtualCursor/CursorStateBuffer.h"
+
+
+DECLARE_STATS_GROUP(TEXT("VirtualCursor"), STATGROUP_VirtualCursor, STATCAT_Advanced);
+
+
+/** Cursor work in the order it is protected when a frame runs over budget */
+enum class ECursorWorkPriority : uint8
+{
+	/** Cursor physics and position. Never deferred. */
+	Physics,
+
+	/** Hover resolution. Deferred cursors keep last frame's hover. */
+	Hover,
+
+	/** World picks, world widgets, heatmaps and telemetry */
+	Optional,
+
+	Num
+};
+
+
+/**
+ * Per-frame CPU budget shared by every cursor.
+ *
+ * Work asks TryBegin before it runs and reports its cost with Charge. Physics always runs; hover and optional work
+ * run while the frame's spend, plus what higher priorities are expected to need, fits the budget.
+ * Work that doesn't fit is deferred, except for one player per priority per frame chosen round robin among the players
+ * that asked for that work, so every player's deferred work still makes progress.
+ * Players are identified by their cursor's FVirtualCursorStateBuffer slot, which is unique across PIE instances.
+ * Work done for all players at once asks as SharedWork, which takes its turn like one more player.
+ */
+class VIRTUALCURSOR_API FVirtualCursorFrameBudget
+{
+public:
+
+	static FVirtualCursorFrameBudget& Get();
+
+	/** Requester id for work that serves every player at once, such as the widget snapshots for magnetism and prefetching */
+	static constexpr int32 SharedWork = FVirtualCursorStateBuffer::MaxCursors;
+
+	/** Game thread only. Returns true if work of this priority may run for the player in this state slot, or for SharedWork, now. */
+	bool TryBegin(ECursorWorkPriority Priority, int32 StateSlot);
+
+	/** Game thread only. Adds the cost of work that ran. */
+	void Charge(ECursorWorkPriority Priority, uint32 Cycles);
+
+	/** Milliseconds spent on cursor work during the last complete frame */
+	FORCEINLINE float GetLastFrameUsedMs() const
+	{
+		return LastFrameUsedMs;
+	}
+
+	/** Milliseconds allowed per frame, 0 if unlimited */
+	float GetBudgetMs() const;
+
+	/** Number of times work of this priority was deferred during the last complete frame */
+	FORCEINLINE uint32 GetLastFrameDeferrals(ECursorWorkPriority Priority) const
+	{
+		return LastFrameDeferrals[static_cast<int32>(Priority)];
+	}
+
+private:
+
+	/** Closes the previous frame's books if GFrameCounter moved on. */
+	void BeginFrameIfNeeded();
+
+	uint32 GetUsedCycles() const;
+
+	static constexpr int32 NumPriorities = static_cast<int32>(ECursorWorkPriority::Num);
+
+	/** Every state slot, plus SharedWork */
+	static constexpr int32 NumRequesters = SharedWork + 1;
+
+	uint64 CurrentFrame = 0;
+
+	/** Spent this frame, per priority */
+	uint32 UsedCycles[NumPriorities] = {};
+
+	uint32 Deferrals[NumPriorities] = {};
+
+	/** Moving averages of the cost of one run, and of a whole frame, per priority */
+	float AverageRunCycles[NumPriorities] = {};
+	float AverageFrameCycles[NumPriorities] = {};
+
+	/** Requester whose turn it is to run regardless of the budget, per priority */
+	int32 RoundRobinTurn[NumPriorities] = {};
+
+	/** One bit per requester that asked for work this frame, per priority */
+	uint32 Requesters[NumPriorities] = {};
+
+	float LastFrameUsedMs = 0.0f;
+
+	uint32 LastFrameDeferrals[NumPriorities] = {};
+};
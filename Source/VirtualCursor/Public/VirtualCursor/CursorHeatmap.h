@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+
+/** Everything accumulated for one layout (top-level user widget) */
+struct FCursorHeatmapLayer
+{
+	/** Seconds the cursor rested in each cell, row major */
+	TArray<float> DwellSeconds;
+
+	/** Seconds the cursor spent moving through each cell, row major */
+	TArray<float> TravelSeconds;
+
+	/** Seconds spent hovering each interactable widget type */
+	TMap<FName, float> HoverSeconds;
+
+	float TotalSeconds = 0.0f;
+};
+
+
+/**
+ * Fixed-resolution, viewport-normalized histograms of where a cursor dwells and travels, one per layout.
+ * Accumulating is O(1) and only allocates the first time a layout or hovered widget type is seen.
+ */
+class VIRTUALCURSOR_API FCursorHeatmap
+{
+public:
+
+	/** Clears everything and sets the grid resolution used by new layers. */
+	void Reset(FIntPoint InResolution);
+
+	/** 
+	* Adds DeltaTime to the cell under ViewportPosition ((0,0) top left, (1,1) bottom right) of Layout's grid,
+	* and to HoveredWidget's hover time if it isn't NAME_None.
+	*/
+	void Accumulate(FName Layout, const FVector2D& ViewportPosition, bool bMoving, FName HoveredWidget, float DeltaTime);
+
+	FORCEINLINE FIntPoint GetResolution() const
+	{
+		return Resolution;
+	}
+
+	FORCEINLINE const TMap<FName, FCursorHeatmapLayer>& GetLayers() const
+	{
+		return Layers;
+	}
+
+	/** 
+	* Writes every layer to Directory on a worker thread: a dwell and a travel PNG per layout, and a CSV of hover times.
+	* The layers are copied first, so accumulation can carry on while the export runs.
+	*/
+	void ExportAsync(const FString& Directory, const FString& Prefix) const;
+
+private:
+
+	FIntPoint Resolution = FIntPoint(64, 36);
+
+	TMap<FName, FCursorHeatmapLayer> Layers;
+
+	/** Last layer accumulated into, so a stable layout skips the map lookup */
+	FName CachedLayout;
+	FCursorHeatmapLayer* CachedLayer = nullptr;
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Layout/SlateRect.h"
+
+class FSlateApplication;
+class SWidget;
+class SWindow;
+struct FArrangedWidget;
+
+
+/** What a cursor hovers, as resolved against a FCursorHitTestSnapshot */
+struct FCursorHoverResult
+{
+	/** The interactable widget, or invalid if none */
+	TWeakPtr<SWidget> Widget;
+
+	/** Type of Widget, NAME_None if none */
+	FName WidgetType;
+
+	/** Absolute paint bounds of Widget */
+	FSlateRect WidgetRect;
+
+	/** Class name of the outermost user widget under the cursor */
+	FName LayoutName;
+};
+
+
+/**
+ * A flat, immutable copy of the hit-testable widget geometry of every interactive window, in paint order.
+ * Building it walks the whole visible widget tree with ArrangeChildren.
+ * Built once per frame on the game thread; after that any number of threads can query it at once,
+ * since queries only read plain rects and indices and never touch the widgets themselves.
+ */
+class VIRTUALCURSOR_API FCursorHitTestSnapshot
+{
+public:
+
+	/** Game thread only. Walks the visible widget tree of every interactive top-level window and its child windows. */
+	void Build(FSlateApplication& SlateApp);
+
+	/**
+	* Any thread. Finds the interactable widget the Slate hittest would report at AbsolutePosition:
+	* the interactable owner of the topmost hit-testable widget, or failing that the nearest interactable within CursorRadius.
+	* Returns INDEX_NONE if there is none.
+	*/
+	int32 FindInteractable(const FVector2D& AbsolutePosition, float CursorRadius, FName& OutLayoutName) const;
+
+	/**
+	* Any thread. True if a widget with a rotating, scaling or shearing render transform lies within CursorRadius of AbsolutePosition.
+	* FindInteractable only knows the bounds of such widgets, so the answer there has to come from the serial Slate hittest.
+	*/
+	bool NeedsSerialHitTest(const FVector2D& AbsolutePosition, float CursorRadius) const;
+
+	/** Game thread only. Fills OutResult for an index returned by FindInteractable. */
+	void GetHoverResult(int32 InteractableIndex, FName LayoutName, FCursorHoverResult& OutResult) const;
+
+	FORCEINLINE int32 GetNumEntries() const
+	{
+		return Entries.Num();
+	}
+
+	FORCEINLINE int32 GetNumInteractables() const
+	{
+		return InteractableRects.Num();
+	}
+
+	/** Absolute paint bounds of every interactable widget, for consumers that only need geometry */
+	FORCEINLINE const TArray<FSlateRect>& GetInteractableRects() const
+	{
+		return InteractableRects;
+	}
+
+private:
+
+	/** Adds Window's widgets, then those of its child windows on top */
+	void AddWindow(const TSharedRef<SWindow>& Window);
+
+	void AddWidget(const FArrangedWidget& ArrangedWidget, const FSlateRect& ClipRect, int32 InteractableOwner, int32 LayoutIndex, bool bTransformed);
+
+	struct FEntry
+	{
+		/** Hit-testable area, already clipped */
+		FSlateRect Rect;
+
+		/** Index of the nearest interactable widget at or above this one, INDEX_NONE if none */
+		int32 InteractableOwner;
+
+		/** Index into LayoutNames, INDEX_NONE if not under a user widget */
+		int32 LayoutIndex;
+	};
+
+	/** Hit-testable widgets, later entries paint on top */
+	TArray<FEntry> Entries;
+
+	TArray<FSlateRect> InteractableRects;
+
+	TArray<FName> InteractableTypes;
+
+	TArray<int32> InteractableLayouts;
+
+	/** Game thread only */
+	TArray<TWeakPtr<SWidget>> InteractableWidgets;
+
+	TArray<FName> LayoutNames;
+
+	/** Clipped bounds of the hit-testable widgets at or below a shaping render transform */
+	TArray<FSlateRect> TransformedRects;
+};
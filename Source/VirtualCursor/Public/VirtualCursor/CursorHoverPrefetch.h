@@ -0,0 +1,94 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Types/ISlateMetaData.h"
+#include "UObject/SoftObjectPath.h"
+
+class FExtendedAnalogCursor;
+class FCursorHitTestSnapshot;
+class SWidget;
+class UVirtualCursorManager;
+class UWidget;
+struct FStreamableHandle;
+
+
+/**
+ * Tags a Slate widget with the assets its hover state needs, and the UMG widget to report when a cursor is about to reach it.
+ * Added by UVirtualCursor::RegisterHoverPrefetch.
+ */
+class VIRTUALCURSOR_API FCursorPrefetchMetaData : public ISlateMetaData
+{
+public:
+
+	SLATE_METADATA_TYPE(FCursorPrefetchMetaData, ISlateMetaData)
+
+	TWeakObjectPtr<UWidget> Widget;
+
+	TArray<FSoftObjectPath> Assets;
+
+	/** Keeps Assets loaded for as long as the widget lives, once a cursor first headed for it */
+	TSharedPtr<FStreamableHandle> Handle;
+};
+
+
+/**
+ * Extrapolates every moving cursor along its velocity and finds the first interactable widget it would enter within the horizon.
+ * The first time a cursor heads for a widget, the assets registered on it are requested asynchronously and the player's
+ * OnWidgetAboutToBeHovered is broadcast. Counts how many hovers were predicted beforehand.
+ * Owned by FVirtualCursorTicker, which hands it the frame's hit test snapshot.
+ */
+class VIRTUALCURSOR_API FCursorHoverPrefetcher
+{
+public:
+
+	/** Game thread only. Snapshot holds the interactable widgets, possibly a few frames old. */
+	void Update(const TArray<TWeakObjectPtr<UVirtualCursorManager>>& Managers, const FCursorHitTestSnapshot& Snapshot, float Horizon);
+
+	/** Number of widgets cursors were predicted to reach */
+	FORCEINLINE uint32 GetPredictionCount() const
+	{
+		return PredictionCount;
+	}
+
+	/** Number of times a cursor started hovering a widget */
+	FORCEINLINE uint32 GetHoverCount() const
+	{
+		return HoverCount;
+	}
+
+	/** Number of those hovers that were predicted before the cursor got there */
+	FORCEINLINE uint32 GetHitCount() const
+	{
+		return HitCount;
+	}
+
+private:
+
+	/** Index into Snapshot's interactables of the first one the segment from Start along Delta enters, INDEX_NONE if none */
+	static int32 FindFirstEntered(const FCursorHitTestSnapshot& Snapshot, const FVector2D& Start, const FVector2D& Delta, float& OutTime);
+
+	/** Requests the assets registered on Widget, or the nearest tagged widget above it, and notifies Manager. */
+	void Prefetch(UVirtualCursorManager* Manager, const TSharedRef<SWidget>& Widget, float TimeToHover);
+
+	struct FCursorState
+	{
+		TWeakPtr<FExtendedAnalogCursor> Cursor;
+
+		/** The widget the cursor hovered last frame */
+		TWeakPtr<SWidget> Hovered;
+
+		/** The widget the cursor was last predicted to reach, until it hovers something or the prediction is a horizon old */
+		TWeakPtr<SWidget> Predicted;
+
+		/** When Predicted was predicted */
+		double PredictedTime = 0.0;
+	};
+
+	TArray<FCursorState> CursorStates;
+
+	uint32 PredictionCount = 0;
+
+	uint32 HoverCount = 0;
+
+	uint32 HitCount = 0;
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FRichCurve;
+
+
+/** What FCursorInputConditioner is compiled from, see FCursorTuningSettings::Compile */
+struct FCursorConditioningParams
+{
+	/** Only read while compiling */
+	const FRichCurve* Curve = nullptr;
+
+	float InnerDeadZone = 0.0f;
+	float AxialDeadZone = 0.0f;
+	float OuterDeadZone = 1.0f;
+	float AntiDeadZone = 0.0f;
+	bool bScaledRadial = false;
+
+	bool bUseJitterFilter = false;
+	float FilterMinCutoff = 1.0f;
+	float FilterBeta = 0.0f;
+	float FilterDerivativeCutoff = 1.0f;
+};
+
+
+/**
+ * Turns raw stick values into the normalized response that drives the cursor's acceleration.
+ *
+ * The static stages (axial dead zone, radial or scaled radial dead zone, outer dead zone,
+ * anti-dead zone and the acceleration curve) are compiled into one magnitude -> response table,
+ * so conditioning a sample costs the same however many stages are enabled.
+ * The only dynamic stage is the optional adaptive (1 euro) jitter filter, which runs first.
+ * Once compiled it keeps no reference to the curve, so copies can be used from any thread.
+ */
+class VIRTUALCURSOR_API FCursorInputConditioner
+{
+public:
+
+	/** Number of table intervals between 0 and MaxMagnitude */
+	static constexpr int32 TableResolution = 256;
+
+	/** Largest stick magnitude the table covers. Some controllers report more than 1 on the diagonals. */
+	static constexpr float MaxMagnitude = 1.4143f;
+
+	FCursorInputConditioner();
+
+	/** Bakes the static stages and resets the filter. Revision is what GetCompiledRevision returns afterwards. */
+	void Compile(const FCursorConditioningParams& Params, uint32 Revision);
+
+	/** Returns the direction of the conditioned input scaled by the acceleration curve, or zero inside the dead zones. */
+	FVector2D Condition(const FVector2D& RawInput, float DeltaTime);
+
+	/** What the plugin did before conditioning existed: a radial dead zone followed by the curve. */
+	FVector2D ConditionLegacy(const FVector2D& RawInput) const;
+
+	/** Clears the jitter filter's history. */
+	void ResetFilter();
+
+	/** The revision passed to Compile, UCursorSettings::GetRevision() when compiled from the settings */
+	FORCEINLINE uint32 GetCompiledRevision() const
+	{
+		return CompiledRevision;
+	}
+
+	/** True if Condition can return something other than ConditionLegacy for the same input */
+	FORCEINLINE bool DiffersFromLegacy() const
+	{
+		return bDiffersFromLegacy;
+	}
+
+private:
+
+	/** Evaluates every static stage for one magnitude. Only used while compiling. */
+	float EvaluateStaticStages(const FRichCurve& Curve, float Magnitude) const;
+
+	/** Linear lookup into one of the tables */
+	static float SampleTable(const float (&Table)[TableResolution + 1], float Magnitude);
+
+	FVector2D ApplyJitterFilter(const FVector2D& Input, float DeltaTime);
+
+	/** Magnitude -> curve response, sampled every MaxMagnitude / TableResolution */
+	float ResponseTable[TableResolution + 1];
+
+	/** The curve alone, for ConditionLegacy */
+	float LegacyTable[TableResolution + 1];
+
+	/** Magnitudes at or below this are inside the inner dead zone and skip the table */
+	float InnerThreshold;
+
+	float AxialDeadZone;
+
+	/** Copies of the settings the table was baked from */
+	float InnerDeadZone;
+	float OuterDeadZone;
+	float AntiDeadZone;
+	bool bScaledRadial;
+
+	bool bUseJitterFilter;
+	float FilterMinCutoff;
+	float FilterBeta;
+	float FilterDerivativeCutoff;
+
+	/** 1 euro filter state */
+	FVector2D FilteredValue;
+	FVector2D FilteredDerivative;
+	bool bFilterPrimed;
+
+	bool bDiffersFromLegacy;
+
+	uint32 CompiledRevision;
+};
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "InputCoreTypes.h"
+#include "Framework/Application/AnalogCursor.h"
+#include "VirtualCursor/CursorSettings.h"
+
+
+/** What a key does to a virtual cursor */
+enum class ECursorInputRole : uint8
+{
+	None,
+
+	/** Moves the cursor right for positive values */
+	MoveX,
+
+	/** Moves the cursor up for positive values, like a stick's Y axis */
+	MoveY,
+
+	/** Scrolls up for positive values */
+	Scroll,
+
+	/** Clicks like the Accept navigation action */
+	Click,
+
+	Num,
+};
+
+
+/** One entry of FCursorKeyBindings */
+struct FCursorKeyBinding
+{
+	ECursorInputRole Role = ECursorInputRole::None;
+
+	/** Index of this key's value in the cursor's binding values */
+	uint8 Slot = 0;
+
+	/** The axis mapping's scale, or 1 */
+	float Scale = 1.0f;
+};
+
+
+/**
+ * Which keys drive a cursor and how, flattened into one key -> role table.
+ * Built from the axis and action mappings named in UCursorSettings, falling back to the cursor's stick,
+ * and only rebuilt when those settings, the mappings or the cursor's stick or scroll input change.
+ */
+class VIRTUALCURSOR_API FCursorKeyBindings
+{
+public:
+
+	/** Most keys a table can hold */
+	static constexpr int32 MaxSlots = 255;
+
+	/** Rebuilds the table for a cursor moved by Stick and scrolled by ScrollInput. */
+	void Build(EAnalogStick Stick, ECursorScrollInput ScrollInput);
+
+	/** True if Build has not run since anything the table depends on changed */
+	bool IsStale(EAnalogStick Stick, ECursorScrollInput ScrollInput) const;
+
+	FORCEINLINE const FCursorKeyBinding* Find(const FKey& Key) const
+	{
+		return Table.Find(Key);
+	}
+
+	FORCEINLINE int32 GetNumSlots() const
+	{
+		return Table.Num();
+	}
+
+	/** Marks every table stale. Call after changing input mappings at runtime. */
+	static void Invalidate()
+	{
+		++InputRevision;
+	}
+
+private:
+
+	/** Adds Key unless it already has a role. Returns false if it was skipped. */
+	bool Add(const FKey& Key, ECursorInputRole Role, float Scale);
+
+	/** Adds every key of the named axis mapping */
+	void AddAxis(FName AxisName, ECursorInputRole Role);
+
+	TMap<FKey, FCursorKeyBinding> Table;
+
+	uint32 BuiltSettingsRevision = 0;
+
+	uint32 BuiltInputRevision = 0;
+
+	EAnalogStick BuiltStick = EAnalogStick::Max;
+
+	ECursorScrollInput BuiltScrollInput = ECursorScrollInput::None;
+
+	static uint32 InputRevision;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Layout/SlateRect.h"
+
+
+/** How interactable widgets act on the cursor at one position */
+struct FCursorMagnetismSample
+{
+	/** Towards the centre of the nearest interactable widget, 1 at its edge and fading to 0 at the field's radius */
+	FVector2D Pull = FVector2D::ZeroVector;
+
+	/** 1 over an interactable widget, fading to 0 at the field's radius */
+	float Friction = 0.0f;
+};
+
+
+/**
+ * A coarse grid over one player's viewport of how strongly the interactable widgets around each cell attract and slow the cursor.
+ * Built from plain rects on a worker thread whenever the layout changes and never modified afterwards,
+ * so a cursor can sample it in O(1) without hit testing or locking.
+ */
+class VIRTUALCURSOR_API FCursorMagnetismField
+{
+public:
+
+	/** Largest number of cells along either axis, whatever the cell size */
+	static constexpr int32 MaxResolution = 256;
+
+	/**
+	* Any thread. Rebuilds the grid over ViewportBounds from the absolute InteractableRects.
+	* Widgets attract the cursor from up to Radius outside their edge. Both Radius and CellSize are in absolute pixels.
+	*/
+	void Build(const FSlateRect& ViewportBounds, const TArray<FSlateRect>& InteractableRects, float Radius, float CellSize);
+
+	/** Bilinearly samples the grid at an absolute position, clamped to the viewport. */
+	FCursorMagnetismSample Sample(const FVector2D& AbsolutePosition) const;
+
+	FORCEINLINE bool IsEmpty() const
+	{
+		return Cells.Num() == 0;
+	}
+
+	FORCEINLINE FIntPoint GetResolution() const
+	{
+		return Resolution;
+	}
+
+private:
+
+	FSlateRect Bounds;
+
+	FIntPoint Resolution = FIntPoint::ZeroValue;
+
+	/** Cells per absolute pixel along each axis */
+	FVector2D CellsPerPixel = FVector2D::ZeroVector;
+
+	/** Samples at the cell centres, row major */
+	TArray<FCursorMagnetismSample> Cells;
+};
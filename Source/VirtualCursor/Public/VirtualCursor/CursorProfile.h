@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Engine/DataAsset.h"
+#include "Templates/Atomic.h"
+#include "VirtualCursor/CursorInputConditioner.h"
+#include "VirtualCursor/CursorTuning.h"
+
+#include "CursorProfile.generated.h"
+
+
+/** Everything a cursor copies out of a profile, compiled once per profile revision */
+struct FCompiledCursorProfile
+{
+	FCursorTuning Tuning;
+
+	FCursorInputConditioner Conditioner;
+
+	uint32 Revision = 0;
+};
+
+
+/**
+* Cursor tuning for one player, in place of the project-wide values in UCursorSettings.
+* Assign it with UVirtualCursorManager::SetCursorProfile. The profile is compiled once, into DPI-independent
+* constants and a baked curve table that any number of players share, so switching profiles is a copy.
+*/
+UCLASS(BlueprintType)
+class VIRTUALCURSOR_API UCursorProfile : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+
+	virtual void PostInitProperties() override;
+
+	virtual void PostLoad() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	/** Game thread only. Compiles the profile first if it changed since the last call. */
+	const FCompiledCursorProfile& GetCompiled() const;
+
+	/** Changes whenever the profile is loaded or edited */
+	FORCEINLINE uint32 GetRevision() const
+	{
+		return Revision.Load();
+	}
+
+private:
+
+	/** Bumps Revision past every revision handed out before, so no two profile edits ever share one */
+	void Invalidate();
+
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor", meta = (ShowOnlyInnerProperties))
+	FCursorTuningSettings Tuning;
+
+	/** Atomic since PostLoad can run on the async loading thread while the game thread compiles the profile */
+	TAtomic<uint32> Revision { 0 };
+
+	mutable FCompiledCursorProfile Compiled;
+
+	/**
+	* Shared by every profile, so a cursor can tell any two compiled profiles apart by revision alone.
+	* Atomic since profiles can be loaded, and so invalidated, off the game thread while cursors compare revisions.
+	*/
+	static TAtomic<uint32> RevisionCounter;
+};
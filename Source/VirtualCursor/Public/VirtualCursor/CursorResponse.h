@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Types/ISlateMetaData.h"
+
+#include "CursorResponse.generated.h"
+
+
+/** How the cursor responds while it hovers one widget, relative to the hovered values of the player's tuning */
+USTRUCT(BlueprintType)
+struct FCursorResponseOverride
+{
+	GENERATED_BODY()
+
+	/** Multiplies the hovered max speed. Unused while magnetism is on. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cursor Response", meta = (ClampMin = "0.01"))
+	float MaxSpeedScale = 1.0f;
+
+	/** Multiplies the hovered drag. Unused while magnetism is on, whose friction slows the cursor instead. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cursor Response", meta = (ClampMin = "0.0"))
+	float DragScale = 1.0f;
+
+	/** Multiplies the magnetism pull, 0 lets the cursor move freely over densely packed widgets */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cursor Response", meta = (ClampMin = "0.0"))
+	float MagnetismStrengthScale = 1.0f;
+
+	/** Multiplies the magnetism friction */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Cursor Response", meta = (ClampMin = "0.0"))
+	float MagnetismFrictionScale = 1.0f;
+};
+
+
+/**
+ * Tags a Slate widget, and every widget inside it, with a cursor response override.
+ * Cursors look it up once when their hovered widget changes, so changing it while hovered takes effect on the next hover.
+ */
+class VIRTUALCURSOR_API FCursorResponseMetaData : public ISlateMetaData
+{
+public:
+
+	SLATE_METADATA_TYPE(FCursorResponseMetaData, ISlateMetaData)
+
+	explicit FCursorResponseMetaData(const FCursorResponseOverride& InResponse)
+		: Response(InResponse)
+	{
+	}
+
+	FCursorResponseOverride Response;
+};
@@ -1,12 +1,69 @@
 #pragma once
 
 #include "Engine/DeveloperSettings.h"
+#include "Materials/MaterialParameterCollection.h"
+#include "Styling/SlateBrush.h"
+#include "Templates/Atomic.h"
+#include "VirtualCursor/CursorTuning.h"
 
 #include "CursorSettings.generated.h"
 
 class FExtendedAnalogCursor;
 
 
+/** What scrolls the widget under the cursor */
+UENUM(BlueprintType)
+enum class ECursorScrollInput : uint8
+{
+	/** Analog scrolling is off */
+	None,
+
+	/** The vertical axis of the stick that doesn't move the cursor */
+	OtherStick,
+
+	/** The right trigger scrolls down, the left one up */
+	Triggers,
+};
+
+
+/** The input mode of a player's viewport, as far as its cursor can tell */
+UENUM(BlueprintType)
+enum class ECursorInputMode : uint8
+{
+	/** The viewport ignores input, as after SetInputMode(UIOnly), so only widgets see what the cursor lets through */
+	UIOnly,
+
+	/** Both widgets and the game see what the cursor lets through */
+	GameAndUI,
+
+	Num UMETA(Hidden),
+};
+
+
+/** Which inputs the cursor acts on stop at the cursor, instead of also reaching widgets and the game */
+USTRUCT(BlueprintType)
+struct FCursorInputConsumption
+{
+	GENERATED_BODY()
+
+	/** The stick or keys that move the cursor */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Consumption")
+	bool bConsumeMovement = true;
+
+	/** Keys that click, once the click has been simulated */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Consumption")
+	bool bConsumeClick = true;
+
+	/** The axis that scrolls while analog scrolling is on */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Consumption")
+	bool bConsumeScroll = true;
+
+	/** Every other gamepad key and axis, such as the face buttons and the stick the cursor doesn't use */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Consumption")
+	bool bConsumeOtherGamepadKeys = false;
+};
+
+
 UCLASS(config=Game, defaultconfig)
 class VIRTUALCURSOR_API UCursorSettings : public UDeveloperSettings
 {
@@ -16,147 +73,315 @@ public:
 
 	UCursorSettings()
 	{
-		MaxAnalogCursorSpeed = 1300.0f;
-		MaxAnalogCursorSpeedWhenHovered = 650.0f;
-		AnalogCursorDragCoefficient = 8.0f;
-		AnalogCursorDragCoefficientWhenHovered = 14.0f;
-		MinAnalogCursorSpeed = 5.0f;
-		AnalogCursorDeadZone = 0.15f;
-		AnalogCursorAccelerationMultiplier = 9000.0f;
-		AnalogCursorSize = 40.0f;
+		MagnetismCellSize = 16.0f;
+		DefaultAnalogScrollInput = ECursorScrollInput::None;
+		ClickLatencyCompensation = 0.0f;
+		TelemetryBufferCapacity = 16384;
+		HeatmapResolution = FIntPoint(64, 36);
+		CursorFrameBudgetMs = 0.0f;
+		HoverPrefetchHorizon = 0.3f;
+		LoadedCursorParameterCollection = nullptr;
+	}
 
-		AnalogCursorAccelerationCurve.EditorCurveData.AddKey(0, 0);
-		AnalogCursorAccelerationCurve.EditorCurveData.AddKey(1, 1);
+	virtual void PostInitProperties() override;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	/** 
+	* Incremented whenever the settings are loaded or edited. 
+	* Anything compiled from the settings can compare this instead of re-reading them.
+	*/
+	static uint32 GetRevision()
+	{
+		return Revision.Load();
 	}
 
 
-	FORCEINLINE const FRichCurve* GetAnalogCursorAccelerationCurve() const
+	/** The project-wide tuning, used by every cursor whose player has no UCursorProfile */
+	FORCEINLINE const FCursorTuningSettings& GetTuning() const
 	{
-		return AnalogCursorAccelerationCurve.GetRichCurveConst();
+		return Tuning;
 	}
 
 
-	FORCEINLINE float GetMaxAnalogCursorSpeed() const
+	FORCEINLINE float GetMagnetismCellSize() const
 	{
-		return MaxAnalogCursorSpeed;
+		return FMath::Max<float>(MagnetismCellSize, 4.0f);
 	}
 
 
-	FORCEINLINE float GetMaxAnalogCursorSpeedWhenHovered() const
+	FORCEINLINE ECursorScrollInput GetDefaultAnalogScrollInput() const
 	{
-		return MaxAnalogCursorSpeedWhenHovered;
+		return DefaultAnalogScrollInput;
 	}
 
 
-	FORCEINLINE float GetAnalogCursorDragCoefficient() const
+	FORCEINLINE FName GetCursorMoveXAxis() const
 	{
-		return FMath::Min<float>(AnalogCursorDragCoefficientWhenHovered, AnalogCursorDragCoefficient);
+		return CursorMoveXAxis;
 	}
 
 
-	FORCEINLINE float GetAnalogCursorDragCoefficientWhenHovered() const
+	FORCEINLINE FName GetCursorMoveYAxis() const
 	{
-		return FMath::Max<float>(AnalogCursorDragCoefficientWhenHovered, AnalogCursorDragCoefficient);
+		return CursorMoveYAxis;
 	}
 
 
-	FORCEINLINE float GetMinAnalogCursorSpeed() const
+	FORCEINLINE FName GetCursorScrollAxis() const
 	{
-		return MinAnalogCursorSpeed;
+		return CursorScrollAxis;
 	}
 
 
-	FORCEINLINE float GetAnalogCursorAccelerationMultiplier() const
+	FORCEINLINE FName GetCursorClickAction() const
 	{
-		return AnalogCursorAccelerationMultiplier;
+		return CursorClickAction;
 	}
 
 
-	FORCEINLINE float GetAnalogCursorDeadZone() const
+	FORCEINLINE const FCursorInputConsumption& GetInputConsumption(const ECursorInputMode Mode) const
 	{
-		return AnalogCursorDeadZone;
+		return Mode == ECursorInputMode::UIOnly ? UIOnlyInputConsumption : GameAndUIInputConsumption;
 	}
 
 
-	FORCEINLINE float GetAnalogCursorSize() const
+	FORCEINLINE bool GetUseEngineAnalogCursor() const
 	{
-		return FMath::Max<float>(AnalogCursorSize, 1.0f);
+		return bUseEngineAnalogCursor;
 	}
 
 
-	FORCEINLINE FVector2D GetAnalogCursorSizeVector() const
+	FORCEINLINE bool GetDefaultClampToViewport() const
 	{
-		return FVector2D(GetAnalogCursorSize(), GetAnalogCursorSize());
+		return bDefaultClampToViewport;
 	}
 
 
-	FORCEINLINE float GetAnalogCursorRadius() const
+	FORCEINLINE bool GetResolveHoverInParallel() const
 	{
-		return GetAnalogCursorSize() / 2.0f;
+		return bResolveHoverInParallel;
 	}
 
 
-	FORCEINLINE bool GetUseEngineAnalogCursor() const
+	FORCEINLINE float GetCursorFrameBudgetMs() const
 	{
-		return bUseEngineAnalogCursor;
+		return CursorFrameBudgetMs;
 	}
 
 
-	FORCEINLINE bool GetAnalogCursorNoAcceleration() const
+	FORCEINLINE bool GetPrefetchHoverAssets() const
 	{
-		return bAnalogCursorNoAcceleration;
+		return bPrefetchHoverAssets;
 	}
 
 
-	FORCEINLINE bool GetDefaultClampToViewport() const
+	FORCEINLINE float GetHoverPrefetchHorizon() const
 	{
-		return bDefaultClampToViewport;
+		return FMath::Max<float>(HoverPrefetchHorizon, 0.0f);
 	}
 
 
-private:
-	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor", meta=(
-		XAxisName="Strength",
-		YAxisName="Acceleration" ))
-	FRuntimeFloatCurve AnalogCursorAccelerationCurve;
+	FORCEINLINE float GetClickLatencyCompensation() const
+	{
+		return ClickLatencyCompensation;
+	}
+
+
+	FORCEINLINE bool GetSimulateClickOnEnable() const
+	{
+		return bSimulateClickOnEnable;
+	}
+
+
+	FORCEINLINE bool GetPersistCursorState() const
+	{
+		return bPersistCursorState;
+	}
+
+
+	FORCEINLINE bool GetTickDuringLoads() const
+	{
+		return bTickDuringLoads;
+	}
+
+
+	FORCEINLINE FIntPoint GetHeatmapResolution() const
+	{
+		return HeatmapResolution;
+	}
 
-	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor", meta = (ClampMin = "1.0"))
-	float MaxAnalogCursorSpeed;
 
-	/** The max speed of the Analog Cursor when hovering over a widget that is interactable */
-	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor", meta = (ClampMin = "1.0"))
-	float MaxAnalogCursorSpeedWhenHovered;
+	FORCEINLINE int32 GetTelemetryBufferCapacity() const
+	{
+		return TelemetryBufferCapacity;
+	}
 
-	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor", meta = (ClampMin = "0.0"))
-	float AnalogCursorDragCoefficient;
 
-	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor", meta = (ClampMin = "0.0"))
-	float AnalogCursorDragCoefficientWhenHovered;
+	/**
+	* Loads CursorParameterCollection the first time it is called and keeps it loaded from then on.
+	* Returns null if none is set. Game thread only.
+	*/
+	UMaterialParameterCollection* LoadCursorParameterCollection();
 
-	/** The min speed of the analog cursor. If it goes below this value, the speed is set to 0. */
-	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor", meta = (ClampMin = "0.0"))
-	float MinAnalogCursorSpeed;
 
-	/** Deadzone value for input from the analog stick */
-	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor", meta = (ClampMin = "0.0", ClampMax = "1.0"))
-	float AnalogCursorDeadZone;
+	/** The collection LoadCursorParameterCollection loaded, null before then */
+	FORCEINLINE UMaterialParameterCollection* GetLoadedCursorParameterCollection() const
+	{
+		return LoadedCursorParameterCollection;
+	}
 
-	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor", meta = (ClampMin = "1.0"))
-	float AnalogCursorAccelerationMultiplier;
 
-	/** The size (on screen) of the analog cursor */
-	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor", meta = (ClampMin = "0.0"))
-	float AnalogCursorSize;
+	FORCEINLINE const FSlateBrush& GetCursorOverlayBrush() const
+	{
+		return CursorOverlayBrush;
+	}
+
+
+private:
+
+	/** Reads the tuning keys written before they moved into Tuning, so projects keep the values they had configured */
+	void LoadLegacyTuning();
+
+	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor", meta = (ShowOnlyInnerProperties))
+	FCursorTuningSettings Tuning;
+
+	/** Size in pixels of the cells of the magnetism field. Smaller follows small widgets more closely but takes longer to rebuild. */
+	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor|Magnetism", meta = (ClampMin = "4.0"))
+	float MagnetismCellSize;
+
+	/** 
+	* Axis mapping (Project Settings > Input) that moves the cursor horizontally. 
+	* If this or CursorMoveYAxis is set, the cursor is moved by the keys of these mappings instead of the stick given to UVirtualCursorManager::EnableAnalogCursor.
+	*/
+	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor|Bindings")
+	FName CursorMoveXAxis;
+
+	/** Axis mapping that moves the cursor vertically, positive is up */
+	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor|Bindings")
+	FName CursorMoveYAxis;
+
+	/** Axis mapping that scrolls while analog scrolling is on, positive is up. If unset, the analog scroll input picks the keys. */
+	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor|Bindings")
+	FName CursorScrollAxis;
+
+	/** Action mapping whose keys click, in addition to the Accept navigation keys */
+	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor|Bindings")
+	FName CursorClickAction;
+
+	/** 
+	* Inputs stopped at the cursor while the player's viewport ignores input, i.e. after SetInputMode(UIOnly).
+	* Gamepad axes that no binding uses still update FAnalogCursor's stick values, but are only stopped if bConsumeOtherGamepadKeys is set.
+	* Can be changed per player with UVirtualCursorManager::SetInputConsumption.
+	*/
+	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor|Bindings")
+	FCursorInputConsumption UIOnlyInputConsumption;
+
+	/** Inputs stopped at the cursor while the game also receives input */
+	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor|Bindings")
+	FCursorInputConsumption GameAndUIInputConsumption;
+
+	/** What scrolls the widget under the cursor for newly created managers. Can be changed per player with UVirtualCursorManager::SetAnalogScrollInput. */
+	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor|Scrolling")
+	ECursorScrollInput DefaultAnalogScrollInput;
+
+	/** 
+	* How far back in time (seconds) a gamepad click is attributed. The click lands where the cursor was on screen 
+	* this long before the button press, which keeps fast-moving cursors from missing small buttons. 0 disables it.
+	*/
+	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor", meta = (ClampMin = "0.0", ClampMax = "0.25"))
+	float ClickLatencyCompensation;
+
+	/** 
+	* If true, the widget geometry is snapshotted once per frame and every player's hover is resolved against it on worker threads,
+	* instead of each cursor hit testing through Slate in turn. Pays off with several local players; building the snapshot walks the
+	* whole widget tree with ArrangeChildren every frame, which with a single player usually costs more than it saves.
+	* Cursors over widgets with a rotating or scaling render transform still hit test through Slate.
+	* VirtualCursor.ValidateParallelHover and VirtualCursor.BenchmarkHover compare it against the serial path.
+	*/
+	UPROPERTY(config, EditAnywhere, Category = "Performance")
+	bool bResolveHoverInParallel;
+
+	/** 
+	* CPU time all cursors together may spend per frame, in milliseconds. 0 means unlimited.
+	* Physics always runs. Over budget, hover resolution keeps its last result and world picks and telemetry are skipped,
+	* taking turns between players. See "stat VirtualCursor".
+	*/
+	UPROPERTY(config, EditAnywhere, Category = "Performance", meta = (ClampMin = "0.0", UIMin = "0.0", UIMax = "2.0"))
+	float CursorFrameBudgetMs;
+
+	/** 
+	* If true, each moving cursor's path is extrapolated against the interactable widgets, and widgets it is about to reach
+	* get their registered assets streamed in and OnWidgetAboutToBeHovered broadcast. See UVirtualCursor::RegisterHoverPrefetch.
+	*/
+	UPROPERTY(config, EditAnywhere, Category = "Performance")
+	bool bPrefetchHoverAssets;
+
+	/** How far ahead, in seconds at the cursor's current velocity, widgets are predicted */
+	UPROPERTY(config, EditAnywhere, Category = "Performance", meta = (ClampMin = "0.0", UIMax = "1.0", EditCondition = "bPrefetchHoverAssets"))
+	float HoverPrefetchHorizon;
 
 	/** If true, defaults to the Engine's Analog Cursor */
 	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor")
 	bool bUseEngineAnalogCursor;
 
-	/** If true, AnalogCursorAccelerationCurve will be used as a Velocity Curve */
-	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor")
-	bool bAnalogCursorNoAcceleration;
-
 	/** True if the cursors should clamp to their viewport by default. */
 	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor")
 	bool bDefaultClampToViewport;
+
+	/**
+	* If true, enabling a cursor fakes a mouse click at the center of the player's viewport to gain focus and capture.
+	* This is the legacy behaviour; it routes a full click through the widget tree and may press whatever is under the center.
+	* If false, focus and capture are given directly to the player's game viewport widget.
+	*/
+	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor", AdvancedDisplay)
+	bool bSimulateClickOnEnable;
+
+	/**
+	* If true, cursors survive map travel and the re-creation of their manager.
+	* Position, velocity, input mode and debug flags are kept, and the cursor is rebound to the new
+	* local player and world without re-centering or any simulated input.
+	*/
+	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor")
+	bool bPersistCursorState;
+
+	/**
+	* If true, cursors keep moving on a separate thread while the game thread is blocked by a map load or a MoviePlayer loading screen.
+	* Hover is paused meanwhile. If a loading screen pumps input, e.g. while it waits on its movie, Accept presses are still
+	* sent to Slate at the cursor's position, so its buttons can be clicked. Draw the cursors on it with FVirtualCursorPlugin::MakeCursorOverlay.
+	*/
+	UPROPERTY(config, EditAnywhere, Category = "Analog Cursor")
+	bool bTickDuringLoads;
+
+	/**
+	* Optional collection that receives every cursor's state once per frame, for cursor-reactive materials.
+	* Player N writes the vector parameter "VirtualCursorN": XY is the position normalized to the player's viewport,
+	* ZW the velocity in viewport sizes per second.
+	*/
+	UPROPERTY(config, EditAnywhere, Category = "Rendering")
+	TSoftObjectPtr<UMaterialParameterCollection> CursorParameterCollection;
+
+	/** Holds CursorParameterCollection once loaded, so every cursor writes to it without loading it again or letting it be collected */
+	UPROPERTY(Transient)
+	UMaterialParameterCollection* LoadedCursorParameterCollection;
+
+	/** Brush the cursor overlay draws every player's cursor with, unless the player was given one of their own */
+	UPROPERTY(config, EditAnywhere, Category = "Rendering")
+	FSlateBrush CursorOverlayBrush;
+
+	/** 
+	* How many per-frame records the telemetry ring holds before new ones are dropped. 
+	* Each cursor adds one record per frame, so 8 players at 240 fps fill 16384 records in about 8 seconds if the writer stalls.
+	*/
+	UPROPERTY(config, EditAnywhere, Category = "Telemetry", meta = (ClampMin = "64"))
+	int32 TelemetryBufferCapacity;
+
+	/** Number of cells across and down each player's viewport in cursor heatmaps */
+	UPROPERTY(config, EditAnywhere, Category = "Telemetry", meta = (ClampMin = "1"))
+	FIntPoint HeatmapResolution;
+
+	/** Atomic, since settings objects can be created off the game thread while cursors compare revisions */
+	static TAtomic<uint32> Revision;
 };
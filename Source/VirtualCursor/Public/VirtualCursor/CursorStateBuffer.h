@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Atomic.h"
+
+
+/** A copy of one cursor's state, as published at the end of its Tick. */
+struct FVirtualCursorSnapshot
+{
+	/** Absolute (desktop space) position of the cursor */
+	FVector2D Position = FVector2D::ZeroVector;
+
+	/** Velocity of the cursor, in absolute units per second */
+	FVector2D Velocity = FVector2D::ZeroVector;
+
+	/** Position of the cursor normalized to its player's viewport, (0,0) top left and (1,1) bottom right */
+	FVector2D ViewportPosition = FVector2D::ZeroVector;
+
+	/** Velocity in the same normalized units, viewports per second */
+	FVector2D ViewportVelocity = FVector2D::ZeroVector;
+
+	/** The frame (GFrameCounter) this snapshot was published on */
+	uint64 FrameNumber = 0;
+
+	/** The Slate user that owns the cursor. Not unique across PIE instances; the slot is. */
+	int32 UserIndex = INDEX_NONE;
+
+	/** The slot this snapshot was published to, filled in by the buffer */
+	int32 StateSlot = INDEX_NONE;
+
+	/** False once the cursor has been disabled or destroyed */
+	bool bActive = false;
+
+	bool bIsUsingAnalogCursor = false;
+
+	bool bHovered = false;
+};
+
+
+/**
+ * Fixed table of cursor snapshots, one slot per cursor.
+ * Slots are handed out per cursor rather than by controller id, since every PIE instance and in-process client numbers its
+ * local players from 0 again.
+ * Each slot has a single writer, which publishes it once per frame through a sequence lock, so any thread can read it
+ * without taking a lock or touching a UObject.
+ *
+ * The game thread writes a slot from AcquireSlot on. While the game thread is blocked by a load, the slot is handed over:
+ * FExtendedAnalogCursor::BeginLoadingTick releases it, the loading thread claims it before its first step and releases it
+ * once it stops, and FExtendedAnalogCursor::EndLoadingTick claims it back for the game thread.
+ * Writing a slot from any other thread than its writer asserts.
+ */
+class VIRTUALCURSOR_API FVirtualCursorStateBuffer
+{
+public:
+
+	static constexpr int32 MaxCursors = 8;
+
+	static FVirtualCursorStateBuffer& Get();
+
+	/** Game thread only. Reserves a free slot for a new cursor, INDEX_NONE if all MaxCursors are taken. */
+	int32 AcquireSlot();
+
+	/** Game thread only. Retires the slot and makes it available to the next cursor. */
+	void ReleaseSlot(int32 Slot);
+
+	/** Makes the calling thread the only one allowed to write the slot. The slot must have been released by its previous writer. */
+	void ClaimWriter(int32 Slot);
+
+	/** Called by the slot's writer. Leaves the slot without a writer until the next ClaimWriter. */
+	void ReleaseWriter(int32 Slot);
+
+	/** Writer only. Overwrites the slot. */
+	void Publish(int32 Slot, const FVirtualCursorSnapshot& Snapshot);
+
+	/** Writer only. Marks the slot as inactive. */
+	void Retire(int32 Slot);
+
+	/** 
+	* Any thread. Copies the latest snapshot in the slot.
+	* Returns false if the slot was never published or the writer kept it busy for too long.
+	*/
+	bool Read(int32 Slot, FVirtualCursorSnapshot& OutSnapshot) const;
+
+	/** Any thread. Copies every active snapshot into OutSnapshots and returns how many were copied. */
+	int32 ReadAll(FVirtualCursorSnapshot (&OutSnapshots)[MaxCursors]) const;
+
+private:
+
+	struct FSlot
+	{
+		/** Odd while the writer is writing Data */
+		TAtomic<uint32> Sequence { 0 };
+
+		/** Id of the thread that may write Data, 0 while it is being handed over */
+		TAtomic<uint32> WriterThreadId { 0 };
+
+		FVirtualCursorSnapshot Data;
+
+		/** Game thread only. True while a cursor holds the slot. */
+		bool bTaken = false;
+	};
+
+	void Write(int32 Slot, const FVirtualCursorSnapshot& Snapshot);
+
+	FSlot Slots[MaxCursors];
+};
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/CircularQueue.h"
+#include "HAL/Runnable.h"
+#include "Templates/Atomic.h"
+
+class FArchive;
+class FEvent;
+class FRunnableThread;
+
+
+/** One cursor, one frame. Fixed size so the ring buffer never allocates. */
+struct FCursorTelemetryRecord
+{
+	uint64 FrameNumber = 0;
+
+	double Time = 0.0;
+
+	FVector2D Position = FVector2D::ZeroVector;
+
+	FVector2D Velocity = FVector2D::ZeroVector;
+
+	/** Type of the hovered widget, NAME_None if nothing interactable is hovered */
+	FName HoveredWidget;
+
+	/** Cycles spent in FExtendedAnalogCursor::Tick this frame */
+	uint32 TickCycles = 0;
+
+	int32 UserIndex = INDEX_NONE;
+
+	bool bIsUsingAnalogCursor = false;
+};
+
+
+/**
+ * Opt-in stream of per-frame cursor state to a CSV file.
+ *
+ * Cursors push fixed-size records into a lock-free single producer / single consumer ring from the game thread,
+ * and a background thread drains the ring to disk. When the ring is full the record is dropped and counted,
+ * so the game thread never waits on the writer or on file I/O. Records the cursors skip to stay within their frame budget
+ * are counted as dropped too.
+ */
+class VIRTUALCURSOR_API FVirtualCursorTelemetry : public FRunnable
+{
+public:
+
+	/** 
+	* Starts a new session writing to Filename, ending any running one.
+	* An empty Filename writes to Saved/VirtualCursor with a timestamped name. Returns false if the file couldn't be opened.
+	*/
+	static bool Begin(const FString& Filename, int32 Capacity);
+
+	/** Ends the running session, if any. Blocks until the writer has flushed what is left in the ring. */
+	static void End();
+
+	/** The running session, or null. Game thread only. */
+	static FORCEINLINE FVirtualCursorTelemetry* Get()
+	{
+		return ActiveSession;
+	}
+
+	virtual ~FVirtualCursorTelemetry();
+
+	/** Game thread only. Never blocks. */
+	FORCEINLINE void Record(const FCursorTelemetryRecord& InRecord)
+	{
+		if (!Queue.Enqueue(InRecord))
+		{
+			++DroppedRecords;
+		}
+	}
+
+	/** Game thread only. Counts a record that was not taken, e.g. because the cursor was over its frame budget. */
+	FORCEINLINE void CountDropped()
+	{
+		++DroppedRecords;
+	}
+
+	FORCEINLINE uint64 GetDroppedCount() const
+	{
+		return DroppedRecords.Load(EMemoryOrder::Relaxed);
+	}
+
+	FORCEINLINE uint64 GetWrittenCount() const
+	{
+		return WrittenRecords.Load(EMemoryOrder::Relaxed);
+	}
+
+	FORCEINLINE const FString& GetFilename() const
+	{
+		return Filename;
+	}
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+
+	FVirtualCursorTelemetry(const FString& InFilename, FArchive* InWriter, int32 Capacity);
+
+	/** Writer thread only. Writes everything currently in the ring. */
+	void Drain();
+
+	static FVirtualCursorTelemetry* ActiveSession;
+
+	FString Filename;
+
+	FArchive* Writer;
+
+	TCircularQueue<FCursorTelemetryRecord> Queue;
+
+	TAtomic<uint64> DroppedRecords { 0 };
+
+	TAtomic<uint64> WrittenRecords { 0 };
+
+	TAtomic<bool> bStopping { false };
+
+	FEvent* WakeEvent;
+
+	FRunnableThread* Thread;
+
+	/** Reused by the writer thread to batch lines before each write */
+	TArray<ANSICHAR> LineBuffer;
+};
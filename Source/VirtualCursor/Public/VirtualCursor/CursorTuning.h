@@ -0,0 +1,170 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Curves/CurveFloat.h"
+
+#include "CursorTuning.generated.h"
+
+struct FCursorConditioningParams;
+
+
+/** How the inner dead zone of the cursor stick is applied */
+UENUM()
+enum class ECursorDeadZoneType : uint8
+{
+	/** Input inside the dead zone is ignored, input outside it is used as is (legacy behaviour) */
+	Radial,
+
+	/** Input between the inner and outer dead zones is rescaled to the full 0-1 range, so there is no jump at the edge */
+	ScaledRadial,
+};
+
+
+/** The constants a cursor's physics reads every tick, as authored or already scaled for a player's DPI */
+struct VIRTUALCURSOR_API FCursorTuning
+{
+	float MaxSpeed = 1300.0f;
+	float MaxSpeedHovered = 650.0f;
+	float DragCo = 8.0f;
+	float DragCoHovered = 14.0f;
+	float MinSpeed = 5.0f;
+
+	/** Turns the conditioned stick value into an acceleration */
+	float AccelerationScale = 9000.0f;
+
+	float CursorRadius = 20.0f;
+	bool bNoAcceleration = false;
+
+	/** See the magnetism settings in FCursorTuningSettings */
+	float MagnetismRadius = 64.0f;
+	float MagnetismStrength = 0.5f;
+	float MagnetismFriction = 1.0f;
+
+	/** See the scrolling settings in FCursorTuningSettings */
+	float ScrollSpeed = 12.0f;
+	float ScrollDeadZone = 0.2f;
+	float ScrollStep = 0.25f;
+
+	/** Speeds, drag and radii scale with DPI, acceleration with its square */
+	FCursorTuning GetScaled(float DPIScale) const;
+};
+
+
+/**
+* The authored tuning of a cursor: the project-wide values in UCursorSettings, or a player's UCursorProfile.
+* Cursors never read it directly, Compile turns it into the constants and conditioning they use.
+*/
+USTRUCT()
+struct VIRTUALCURSOR_API FCursorTuningSettings
+{
+	GENERATED_BODY()
+
+	FCursorTuningSettings()
+	{
+		AnalogCursorAccelerationCurve.EditorCurveData.AddKey(0, 0);
+		AnalogCursorAccelerationCurve.EditorCurveData.AddKey(1, 1);
+	}
+
+	/** Fills both with the values below, with every invalid combination clamped away */
+	void Compile(FCursorTuning& OutTuning, FCursorConditioningParams& OutParams) const;
+
+	FORCEINLINE float GetCursorRadius() const
+	{
+		return FMath::Max<float>(AnalogCursorSize, 1.0f) / 2.0f;
+	}
+
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor", meta=(
+		XAxisName="Strength",
+		YAxisName="Acceleration" ))
+	FRuntimeFloatCurve AnalogCursorAccelerationCurve;
+
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor", meta = (ClampMin = "1.0"))
+	float MaxAnalogCursorSpeed = 1300.0f;
+
+	/** The max speed of the Analog Cursor when hovering over a widget that is interactable. Not used while magnetism is on. */
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor", meta = (ClampMin = "1.0"))
+	float MaxAnalogCursorSpeedWhenHovered = 650.0f;
+
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor", meta = (ClampMin = "0.0"))
+	float AnalogCursorDragCoefficient = 8.0f;
+
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor", meta = (ClampMin = "0.0"))
+	float AnalogCursorDragCoefficientWhenHovered = 14.0f;
+
+	/** The min speed of the analog cursor. If it goes below this value, the speed is set to 0. */
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor", meta = (ClampMin = "0.0"))
+	float MinAnalogCursorSpeed = 5.0f;
+
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor", meta = (ClampMin = "1.0"))
+	float AnalogCursorAccelerationMultiplier = 9000.0f;
+
+	/** If true, AnalogCursorAccelerationCurve will be used as a Velocity Curve */
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor")
+	bool bAnalogCursorNoAcceleration = false;
+
+	/** The size (on screen) of the analog cursor */
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor", meta = (ClampMin = "0.0"))
+	float AnalogCursorSize = 40.0f;
+
+	/** Deadzone value for input from the analog stick */
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float AnalogCursorDeadZone = 0.15f;
+
+	/** How AnalogCursorDeadZone is applied to the stick's magnitude */
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor|Conditioning")
+	ECursorDeadZoneType AnalogCursorDeadZoneType = ECursorDeadZoneType::Radial;
+
+	/** Per-axis dead zone applied before the radial one, for sticks that drift along a single axis. 0 disables it. */
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor|Conditioning", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float AnalogCursorAxialDeadZone = 0.0f;
+
+	/** Stick magnitude at and above which the input is treated as fully deflected */
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor|Conditioning", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float AnalogCursorOuterDeadZone = 1.0f;
+
+	/** Smallest magnitude fed to the acceleration curve once the input leaves the dead zone. Compensates for games or curves with their own dead zone. */
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor|Conditioning", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float AnalogCursorAntiDeadZone = 0.0f;
+
+	/** If true, stick input is smoothed with an adaptive (1 euro) filter: heavy smoothing when the stick is still, almost none when it moves fast */
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor|Conditioning")
+	bool bUseJitterFilter = false;
+
+	/** Cutoff frequency (Hz) of the jitter filter when the stick is still. Lower removes more jitter but adds lag at low speeds. */
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor|Conditioning", meta = (ClampMin = "0.001", EditCondition = "bUseJitterFilter"))
+	float JitterFilterMinCutoff = 1.0f;
+
+	/** How quickly the jitter filter's cutoff rises with stick speed. Higher reduces lag during fast movement. */
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor|Conditioning", meta = (ClampMin = "0.0", EditCondition = "bUseJitterFilter"))
+	float JitterFilterBeta = 0.5f;
+
+	/** Cutoff frequency (Hz) used to smooth the stick speed the jitter filter adapts to */
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor|Conditioning", meta = (ClampMin = "0.001", EditCondition = "bUseJitterFilter"))
+	float JitterFilterDerivativeCutoff = 1.0f;
+
+	/** How far outside an interactable widget's edge magnetism still pulls the cursor, before DPI scaling */
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor|Magnetism", meta = (ClampMin = "0.0"))
+	float MagnetismRadius = 64.0f;
+
+	/** Pull towards the nearest widget's centre, as a fraction of the acceleration the stick is currently giving */
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor|Magnetism", meta = (ClampMin = "0.0", UIMax = "2.0"))
+	float MagnetismStrength = 0.5f;
+
+	/** Drag added over a widget, as a multiple of the normal drag. It fades out towards MagnetismRadius, and replaces the hovered drag and max speed. */
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor|Magnetism", meta = (ClampMin = "0.0", UIMax = "4.0"))
+	float MagnetismFriction = 1.0f;
+
+	/** Mouse wheel notches per second at full deflection. Deflection is squared first, so small movements scroll finely. */
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor|Scrolling", meta = (ClampMin = "0.0"))
+	float AnalogScrollSpeed = 12.0f;
+
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor|Scrolling", meta = (ClampMin = "0.0", ClampMax = "0.99"))
+	float AnalogScrollDeadZone = 0.2f;
+
+	/**
+	* Smallest wheel delta sent, in notches. Scrolling accumulates until it reaches a whole number of steps,
+	* and at most one wheel event per player is sent each frame.
+	*/
+	UPROPERTY(EditAnywhere, Category = "Analog Cursor|Scrolling", meta = (ClampMin = "0.01", ClampMax = "1.0"))
+	float AnalogScrollStep = 0.25f;
+};
@@ -1,6 +1,19 @@
 #pragma once
 
 #include "Framework/Application/AnalogCursor.h"
+#include "HAL/CriticalSection.h"
+#include "Layout/WidgetPath.h"
+#include "Templates/Atomic.h"
+#include "VirtualCursor/CursorDebugHistory.h"
+#include "VirtualCursor/CursorHitTestSnapshot.h"
+#include "VirtualCursor/CursorInputConditioner.h"
+#include "VirtualCursor/CursorKeyBindings.h"
+#include "VirtualCursor/CursorMagnetismField.h"
+#include "VirtualCursor/CursorProfile.h"
+#include "VirtualCursor/CursorResponse.h"
+#include "VirtualCursor/CursorSettings.h"
+
+class UWidgetInteractionComponent;
 
 
 class VIRTUALCURSOR_API FExtendedAnalogCursor : public FAnalogCursor
@@ -12,7 +25,7 @@ public:
 	FExtendedAnalogCursor(ULocalPlayer* InLocalPlayer, UWorld* InWorld, float _Radius);
 	FExtendedAnalogCursor(class APlayerController* PlayerController, float _Radius);
 
-	virtual ~FExtendedAnalogCursor() {}
+	virtual ~FExtendedAnalogCursor();
 
 	virtual int32 GetOwnerUserIndex() const override;
 
@@ -35,16 +48,131 @@ public:
 	*/
 	void SetClampToViewport(bool bNewClampToViewport);
 
+	/** 
+	* Hands this cursor a hover result resolved off the game thread for Position.
+	* Tick uses it instead of hit testing if the cursor is still at Position this frame.
+	*/
+	void SetPrecomputedHover(const FVector2D& Position, const FCursorHoverResult& Result);
+
+	/**
+	* Points this cursor at a new local player and world, keeping all of its state.
+	* Used when a cursor outlives map travel or its manager. Does not re-center or simulate any input.
+	*/
+	void Rebind(ULocalPlayer* InLocalPlayer, UWorld* InWorld);
+
+	/** Gets the geometry of this player's area of the viewport. Returns false if there is no game layer to ask. */
+	bool GetPlayerViewportGeometry(FGeometry& outGeometry) const;
+
+	/** 
+	* Turns magnetism on or off. While on, FVirtualCursorTicker keeps a field of the interactable widgets around
+	* this player's viewport up to date, and Tick bends the cursor's acceleration and drag by it.
+	*/
+	void SetMagnetismEnabled(bool bEnabled);
+
+	FORCEINLINE bool IsMagnetismEnabled() const
+	{
+		return bMagnetismEnabled;
+	}
+
+	/** Hands this cursor a freshly built field. Ignored while magnetism is off. */
+	void SetMagnetismField(const TSharedPtr<const FCursorMagnetismField, ESPMode::ThreadSafe>& Field);
+
+	/** How far, in absolute pixels, magnetism reaches outside a widget for this player */
+	FORCEINLINE float GetMagnetismRadius() const
+	{
+		return ScaledTuning.MagnetismRadius;
+	}
+
+	/** 
+	* Sets what scrolls the widget under the cursor. Whether that input still reaches the game is up to the input consumption policy.
+	* Scrolling sends at most one mouse wheel event per frame, along the widget path hover resolution found.
+	*/
+	void SetScrollInput(ECursorScrollInput InScrollInput);
+
+	FORCEINLINE ECursorScrollInput GetScrollInput() const
+	{
+		return ScrollInput;
+	}
+
+	/** Sets which of the inputs this cursor acts on stop at it while the player's viewport is in Mode */
+	void SetInputConsumption(ECursorInputMode Mode, const FCursorInputConsumption& Consumption);
+
+	/** UIOnly while the player's viewport ignores input, which SetInputMode(UIOnly) does and the other input modes undo */
+	ECursorInputMode GetInputMode() const;
+
+	/** Number of events with this role the consumption policy stopped at the cursor since the last reset. None counts the other gamepad keys. */
+	FORCEINLINE uint32 GetAbsorbedEventCount(const ECursorInputRole Role) const
+	{
+		return AbsorbedEventCounts[static_cast<uint8>(Role)];
+	}
+
+	FORCEINLINE void ResetAbsorbedEventCounts()
+	{
+		FMemory::Memzero(AbsorbedEventCounts);
+	}
+
+	/**
+	* Switches this cursor's tuning to a compiled copy of Profile, or back to UCursorSettings if null.
+	* Costs one copy; profile edits are picked up on the next Tick.
+	*/
+	void SetProfile(const UCursorProfile* Profile);
+
+	/**
+	* Game thread only. Copies the physics state for TickLoading and hands it, and the cursor's state slot, over until EndLoadingTick.
+	* Meanwhile Tick does nothing, stick input only feeds the loading state, and Accept presses are sent to Slate at the loading position.
+	* Returns false if the cursor has never been placed.
+	*/
+	bool BeginLoadingTick();
+
+	/** 
+	* Game thread only, once TickLoading can no longer be called and the loading thread has released the state slot. 
+	* Takes the physics state and the slot back; the next Tick moves the Slate cursor to it.
+	*/
+	void EndLoadingTick();
+
+	/** Steps the handed over state and publishes it to FVirtualCursorStateBuffer. Loading thread only, after it claimed the state slot. */
+	void TickLoading(double Time, float DeltaTime);
+
+	FORCEINLINE bool IsLoadingTickActive() const
+	{
+		return bLoadingTickActive;
+	}
+
+	/** This cursor's slot in FVirtualCursorStateBuffer, INDEX_NONE if every slot was taken */
+	FORCEINLINE int32 GetStateSlot() const
+	{
+		return StateSlot;
+	}
+
 	FORCEINLINE FName GetHoveredWidgetName() const
 	{
 		return HoveredWidgetName;
 	}
 
+	/** Class name of the outermost user widget under the cursor, NAME_None if there is none or layout tracking is off */
+	FORCEINLINE FName GetHoveredLayoutName() const
+	{
+		return HoveredLayoutName;
+	}
+
+	/** If true, Tick also records which top-level user widget is under the cursor */
+	FORCEINLINE void SetTrackHoveredLayout(bool bTrack)
+	{
+		bTrackHoveredLayout = bTrack;
+		HoveredLayoutName = NAME_None;
+	}
+
 	FORCEINLINE bool IsHovered() const
 	{
 		return HoveredWidgetName != NAME_None;
 	}
 
+	/** The interactable Slate widget under the cursor, invalid over world-space widgets */
+	FORCEINLINE const TWeakPtr<SWidget>& GetHoveredWidget() const
+	{
+		return HoveredWidget;
+	}
+
 	FORCEINLINE FVector2D GetCurrentPosition() const
 	{
 		return CurrentPosition;
@@ -60,6 +188,24 @@ public:
 		return bIsUsingAnalogCursor;
 	}
 
+	/** Number of frames on which input conditioning kept the cursor on the same pixel where the unconditioned input would have moved it */
+	FORCEINLINE uint32 GetSuppressedMoveCount() const
+	{
+		return SuppressedMoveCount;
+	}
+
+	/** Number of suppressed moves that would have taken the cursor off the widget it was hovering */
+	FORCEINLINE uint32 GetSuppressedHoverChangeCount() const
+	{
+		return SuppressedHoverChangeCount;
+	}
+
+	FORCEINLINE void ResetConditioningStats()
+	{
+		SuppressedMoveCount = 0;
+		SuppressedHoverChangeCount = 0;
+	}
+
 	FORCEINLINE FVector2D GetLastCursorDirection() const
 	{
 		return LastCursorDirection;
@@ -70,6 +216,17 @@ public:
 		return Radius;
 	}
 
+	/**
+	* Sets the radius Slate should hit test this cursor with, 0 while the stick isn't driving it.
+	* Slate has a single radius for every user, so FVirtualCursorTicker applies the largest one any enabled cursor requests.
+	*/
+	void RequestCursorRadius(float InRadius);
+
+	FORCEINLINE float GetRequestedCursorRadius() const
+	{
+		return RequestedCursorRadius;
+	}
+
 	FORCEINLINE void SetStick(const EAnalogStick CursorMovementStick)
 	{
 		AnalogStick = CursorMovementStick;
@@ -80,21 +237,161 @@ public:
 		return bClampToViewport;
 	}
 
+	/** Sets the component that drives world-space widgets from this cursor. Its hover counts as widget hover and clicks are forwarded to it. */
+	FORCEINLINE void SetWorldWidgetInteraction(UWidgetInteractionComponent* InWidgetInteraction)
+	{
+		WorldWidgetInteraction = InWidgetInteraction;
+	}
+
+	/** Sets the absolute bounds of the world-space widget under the cursor, used as the hovered rect while it is hovered */
+	FORCEINLINE void SetWorldWidgetRect(const FSlateRect& InWorldWidgetRect)
+	{
+		WorldWidgetRect = InWorldWidgetRect;
+	}
+
+#if WITH_VIRTUALCURSOR_DEBUG
+	FORCEINLINE const FCursorDebugHistory& GetDebugHistory() const
+	{
+		return DebugHistory;
+	}
+#endif
+
+	/** Records key and mouse button events and Tick's results into the debug history */
 	uint8 bDebugging : 1;
 
+	/** Records analog events into the debug history */
 	uint8 bAnalogDebug : 1;
 
 protected:
 
 	bool GetAbsoluteClampedPosition(const FVector2D& inPosition, FVector2D& outPosition);
 
+	/** Publishes this frame's state to FVirtualCursorStateBuffer and the optional material parameter collection. */
+	void PublishState(const FVector2D& ViewportPosition, const FVector2D& ViewportVelocity);
+
 private:
 
-	/** Takes in values from the analog stick, returns a vector that represents acceleration */
-	FVector2D GetAnalogCursorAccelerationValue(const FVector2D& InAnalogValues, float DPIScale) const;
+	/** 
+	* Updates the hovered widget state for Position, from the precomputed result if there is a matching one.
+	* Keeps the previous state if the frame budget defers hover resolution.
+	* Returns true if an interactable widget is hovered.
+	*/
+	bool ResolveHover(FSlateApplication& SlateApp, const FVector2D& Position);
+
+	/** Hit tests through Slate on the game thread. */
+	bool ResolveHoverSerial(FSlateApplication& SlateApp, const FVector2D& Position);
+
+	bool ApplyHoverResult(const FCursorHoverResult& Result);
+
+	/** The response override of the hovered widget. Only looks it up when the hovered widget changed since the last call. */
+	FORCEINLINE const FCursorResponseOverride& GetHoveredResponse()
+	{
+		if (HoveredResponseWidget != HoveredWidget)
+		{
+			ResolveHoveredResponse();
+		}
+		return HoveredResponse;
+	}
+
+	/** Caches the override of the nearest widget tagged with FCursorResponseMetaData, from HoveredWidget up */
+	void ResolveHoveredResponse();
 
-	/** Test whether the input is for the correct stick */
-	bool IsCursorStickInput(const FAnalogInputEvent& AnalogInputEvent) const;
+	/** Adds the position shown on screen this frame, and what it hovered, to PositionHistory. */
+	void RecordPositionHistory(double Time, const FVector2D& Position);
+
+	/** 
+	* Finds where the cursor was on screen at EventTime minus the latency compensation.
+	* Returns false if the click should go to the current position, either because compensation is off,
+	* there is no history yet or the recorded position hovered the same widget as now.
+	*/
+	bool ResolveClickPosition(double EventTime, FVector2D& OutPosition) const;
+
+	/** 
+	* While the loading thread owns the cursor, moves the Slate cursor of the event's user to the loading position,
+	* so a simulated click lands where the player sees the cursor.
+	*/
+	void MoveSlateCursorToLoadingPosition(FSlateApplication& SlateApp, const FInputEvent& InputEvent);
+
+	/** Size of this player's viewport */
+	FVector2D GetPlayerViewportSize() const;
+
+	/** One RK4 step of InVelocity (or the acceleration itself with bNoAcceleration), zeroed below MinSpeed and capped at InMaxSpeed */
+	static FVector2D IntegrateVelocity(const FVector2D& InVelocity, const FVector2D& Acceleration, float DragCo, float MinSpeed, float InMaxSpeed, bool bNoAcceleration, float DeltaTime);
+
+	/** Takes in conditioned values from the analog stick, returns a vector that represents acceleration */
+	FORCEINLINE FVector2D GetAnalogCursorAccelerationValue(const FVector2D& InConditionedValues) const
+	{
+		// The curve has already been applied by the conditioner
+		return InConditionedValues * ScaledTuning.AccelerationScale;
+	}
+
+	/** Recompiles Tuning and InputConditioner if the profile, or the settings without one, changed since they were compiled */
+	FORCEINLINE void RefreshTuning()
+	{
+		const UCursorProfile* CurrentProfile = Profile.Get();
+		const uint32 SourceRevision = CurrentProfile ? CurrentProfile->GetRevision() : UCursorSettings::GetRevision();
+		if (CurrentProfile != TuningSource || SourceRevision != TuningRevision)
+		{
+			ApplyTuning(CurrentProfile);
+		}
+	}
+
+	/** Copies the compiled tuning and conditioner of Source, or compiles them from UCursorSettings if null */
+	void ApplyTuning(const UCursorProfile* Source);
+
+	/** Rescales ScaledTuning if the player's viewport was resized since it was last scaled. The DPI curve is only read then. */
+	void RefreshScaledTuning();
+
+	/** 
+	* Counts the frames on which conditioning held the cursor still where the legacy dead zone alone would have moved it.
+	* Only a few vector operations, and skipped entirely when the conditioner behaves like the legacy path.
+	*/
+	void AccumulateConditioningStats(const FVector2D& RawAnalogValues, const FVector2D& NextPosition, float DragCo, float DeltaTime);
+
+	/** Adds an input event to the debug history if bEnabled. Compiles to nothing without WITH_VIRTUALCURSOR_DEBUG. */
+	FORCEINLINE void RecordDebugInput(const bool bEnabled, const FKey& Key, const ECursorDebugInput Kind, const float Value = 0.0f)
+	{
+#if WITH_VIRTUALCURSOR_DEBUG
+		if (bEnabled)
+		{
+			DebugHistory.AddInput(Key.GetFName(), Kind, Value);
+		}
+#endif
+	}
+
+	/** Looks Key up in KeyBindings, rebuilding them first if they are stale. Null if the key doesn't drive this cursor. */
+	const FCursorKeyBinding* FindBinding(const FKey& Key);
+
+	/** Stores a bound key's value, scaled by its binding, and keeps RoleValues in sync */
+	void SetBindingValue(const FCursorKeyBinding& Binding, float Value);
+
+	FORCEINLINE float GetRoleValue(const ECursorInputRole Role) const
+	{
+		return FMath::Clamp(RoleValues[static_cast<uint8>(Role)], -1.0f, 1.0f);
+	}
+
+	/** Movement from the bound keys, with Y pointing down like FAnalogCursor::GetAnalogValues */
+	FORCEINLINE FVector2D GetMoveInput() const
+	{
+		return FVector2D(GetRoleValue(ECursorInputRole::MoveX), -GetRoleValue(ECursorInputRole::MoveY));
+	}
+
+	FORCEINLINE bool IsScrolling() const
+	{
+		return FMath::Abs(GetRoleValue(ECursorInputRole::Scroll)) > ScaledTuning.ScrollDeadZone;
+	}
+
+	/** 
+	* Returns whether an event with this role that the cursor acted on stops here, per the policy for the current input mode, and counts it if so.
+	* Role None stands for the gamepad keys the cursor doesn't use.
+	*/
+	bool ConsumeInput(ECursorInputRole Role);
+
+	/** The same for a key event once the cursor is done with it. bHandledAsClick is whether it simulated a click. */
+	bool ConsumeKeyEvent(FSlateApplication& SlateApp, const FKeyEvent& KeyEvent, bool bHandledAsClick);
+
+	/** Integrates the scroll deflection and sends whole scroll steps as one wheel event, to the widgets under Position. */
+	void TickScroll(FSlateApplication& SlateApp, const FVector2D& Position, float DeltaTime);
 
 	/** Current velocity of the cursor */
 	FVector2D Velocity;
@@ -108,6 +405,69 @@ private:
 	/** The name of the hovered widget */
 	FName HoveredWidgetName;
 
+	/** Class name of the outermost user widget under the cursor */
+	FName HoveredLayoutName;
+
+	bool bTrackHoveredLayout = false;
+
+	/** Absolute bounds of the hovered widget, only meaningful while HoveredWidgetName is set */
+	FSlateRect HoveredWidgetRect;
+
+	/** The hovered interactable widget itself */
+	TWeakPtr<SWidget> HoveredWidget;
+
+	/** The widget HoveredResponse was resolved for */
+	TWeakPtr<SWidget> HoveredResponseWidget;
+
+	FCursorResponseOverride HoveredResponse;
+
+	/** Hover resolved by FVirtualCursorTicker, valid for PrecomputedHoverFrame at PrecomputedHoverPosition only */
+	FCursorHoverResult PrecomputedHover;
+
+	FVector2D PrecomputedHoverPosition = FVector2D(FLT_MAX, FLT_MAX);
+
+	uint64 PrecomputedHoverFrame = 0;
+
+	struct FPositionHistoryEntry
+	{
+		double Time = 0.0;
+		FVector2D Position = FVector2D::ZeroVector;
+		TWeakPtr<SWidget> HoveredWidget;
+	};
+
+	static constexpr int32 PositionHistorySize = 16;
+
+	/** Ring of the last PositionHistorySize on-screen positions, PositionHistoryHead is the newest */
+	FPositionHistoryEntry PositionHistory[PositionHistorySize];
+
+	int32 PositionHistoryHead = INDEX_NONE;
+
+	/** Set while a click was redirected to an earlier position, so its release goes to the same place */
+	TOptional<FVector2D> RedirectedClickPosition;
+
+	/** Dead zones, acceleration curve and jitter filter for the stick */
+	FCursorInputConditioner InputConditioner;
+
+	/** Speeds, drag and acceleration as authored in the profile or settings */
+	FCursorTuning Tuning;
+
+	/** Tuning scaled by the DPI of ScaledTuningViewportSize, what Tick actually reads */
+	FCursorTuning ScaledTuning;
+
+	FVector2D ScaledTuningViewportSize = FVector2D::ZeroVector;
+
+	/** Optional per-player profile, UCursorSettings is used while there is none */
+	TWeakObjectPtr<const UCursorProfile> Profile;
+
+	/** Profile Tuning was compiled from, only compared against, never dereferenced */
+	const UCursorProfile* TuningSource = nullptr;
+
+	uint32 TuningRevision = 0;
+
+	uint32 SuppressedMoveCount = 0;
+
+	uint32 SuppressedHoverChangeCount = 0;
+
 	/** Is this thing even active right now? */
 	bool bIsUsingAnalogCursor;
 
@@ -117,9 +477,105 @@ private:
 	/** The radius of the analog cursor */
 	float Radius;
 
+	/** See RequestCursorRadius */
+	float RequestedCursorRadius = 0.0f;
+
 	FLocalPlayerContext PlayerContext;
 
 	TSet<FKey> PressedKeys;
 
 	EAnalogStick AnalogStick = EAnalogStick::Left;
+
+	bool bMagnetismEnabled = false;
+
+	ECursorScrollInput ScrollInput = ECursorScrollInput::None;
+
+	/** Which keys move, scroll and click this cursor */
+	FCursorKeyBindings KeyBindings;
+
+	/** Latest scaled value of every bound key, by slot */
+	TArray<float> BindingValues;
+
+	/** Sum of BindingValues per role */
+	float RoleValues[static_cast<uint8>(ECursorInputRole::Num)] = {};
+
+	/** Whether events of each role stop at the cursor, per input mode */
+	bool ConsumptionTable[static_cast<uint8>(ECursorInputMode::Num)][static_cast<uint8>(ECursorInputRole::Num)] = {};
+
+	uint32 AbsorbedEventCounts[static_cast<uint8>(ECursorInputRole::Num)] = {};
+
+	/** Wheel notches integrated but not sent yet, always less than a step */
+	float ScrollAccumulator = 0.0f;
+
+	/** What ResolveHoverSerial found under the cursor on ScrollPathFrame, only kept while scrolling */
+	FWidgetPath ScrollPath;
+
+	uint64 ScrollPathFrame = 0;
+
+	/** Latest field FVirtualCursorTicker built for this player, null until the first build completes */
+	TSharedPtr<const FCursorMagnetismField, ESPMode::ThreadSafe> MagnetismField;
+
+	/** Optional pointer into world-space widgets, owned by the manager */
+	TWeakObjectPtr<UWidgetInteractionComponent> WorldWidgetInteraction;
+
+	/** Screen bounds of the world-space widget WorldWidgetInteraction is over, set by the manager */
+	FSlateRect WorldWidgetRect;
+
+	/** True while a click has been forwarded to WorldWidgetInteraction and not yet released */
+	bool bWorldWidgetPressed = false;
+
+#if WITH_VIRTUALCURSOR_DEBUG
+	FCursorDebugHistory DebugHistory;
+#endif
+
+	/** Reserved in FVirtualCursorStateBuffer for as long as the cursor lives, so it follows the cursor across rebinds */
+	int32 StateSlot = INDEX_NONE;
+
+	/** 
+	* What TickLoading steps, copied from the cursor and settings by BeginLoadingTick.
+	* The loading thread reads nothing else of the cursor, so everything it publishes has to be in here.
+	*/
+	struct FLoadingState
+	{
+		FVector2D Position = FVector2D::ZeroVector;
+		FVector2D Velocity = FVector2D::ZeroVector;
+		int32 UserIndex = 0;
+		int32 StateSlot = INDEX_NONE;
+
+		/** GFrameCounter when the game thread handed the cursor over; it does not advance while the game thread is blocked */
+		uint64 FrameNumber = 0;
+
+		bool bIsUsingAnalogCursor = false;
+
+		/** Latest stick values and when they arrived. Input stops arriving while the game thread is blocked. */
+		FVector2D Stick = FVector2D::ZeroVector;
+		double StickTime = 0.0;
+
+		FCursorInputConditioner Conditioner;
+
+		/** GetAnalogCursorAccelerationValue with everything but the conditioned input baked in */
+		float AccelerationScale = 0.0f;
+		float DragCo = 0.0f;
+		float MinSpeed = 0.0f;
+		float MaxSpeed = 0.0f;
+		bool bNoAcceleration = false;
+
+		bool bClamp = false;
+
+		/** Absolute area the cursor's center may move in when clamped */
+		FSlateRect ClampBounds;
+
+		/** Absolute area of the player's viewport, for the normalized position */
+		FSlateRect ViewportBounds;
+	};
+
+	/** Shared with the loading thread while bLoadingTickActive */
+	FLoadingState LoadingState;
+
+	FCriticalSection LoadingStateLock;
+
+	TAtomic<bool> bLoadingTickActive { false };
+
+	/** Set by EndLoadingTick until Tick has moved the Slate cursor to the handed back position */
+	bool bPendingLoadingHandBack = false;
 };
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Kismet/BlueprintFunctionLibrary.h"
+#include "Styling/SlateBrush.h"
+#include "VirtualCursor/CursorResponse.h"
 #include "VirtualCursor.generated.h"
 
 
@@ -17,6 +19,70 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Virtual Cursor", meta = (DisplayName = "Disable Virtual Cursor"))
 	static void Disable(class APlayerController* PlayerController);
 
+	/** Enables and centers the virtual cursor of every local player in the world's game instance. */
+	UFUNCTION(BlueprintCallable, Category = "Virtual Cursor", meta = (WorldContext = "WorldContextObject", DisplayName = "Enable Virtual Cursor For All Local Players"))
+	static void EnableForAllLocalPlayers(const UObject* WorldContextObject, bool bUseLeftStick = true);
+
+	/** Disables the virtual cursor of every local player in the world's game instance. */
+	UFUNCTION(BlueprintCallable, Category = "Virtual Cursor", meta = (WorldContext = "WorldContextObject", DisplayName = "Disable Virtual Cursor For All Local Players"))
+	static void DisableForAll(const UObject* WorldContextObject);
+
 	UFUNCTION(BlueprintPure, Category="Virtual Cursor", meta = (DisplayName = "Is Cursor Over Interactable Widget"))
 	static bool IsOverInteractableWidget(class APlayerController* PlayerController);
+
+	/** Draws the cursors of every local player of the world's viewport in one overlay on top of it. Each viewport has its own overlay. */
+	UFUNCTION(BlueprintCallable, Category = "Virtual Cursor|Overlay", meta = (WorldContext = "WorldContextObject"))
+	static void ShowCursorOverlay(const UObject* WorldContextObject, int32 ZOrder = 1000);
+
+	UFUNCTION(BlueprintCallable, Category = "Virtual Cursor|Overlay", meta = (WorldContext = "WorldContextObject"))
+	static void HideCursorOverlay(const UObject* WorldContextObject);
+
+	/** Draws this player's cursor with its own brush and tint instead of the one from the settings, in the overlay of the player's viewport. */
+	UFUNCTION(BlueprintCallable, Category = "Virtual Cursor|Overlay")
+	static void SetCursorOverlayBrush(class APlayerController* PlayerController, const FSlateBrush& Brush, FLinearColor Tint = FLinearColor::White);
+
+	UFUNCTION(BlueprintCallable, Category = "Virtual Cursor|Overlay")
+	static void ClearCursorOverlayBrush(class APlayerController* PlayerController);
+
+	/** 
+	* Starts streaming every cursor's per-frame state to a CSV file, ending any running session.
+	* Leave Filename empty to write a timestamped file under Saved/VirtualCursor.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Virtual Cursor|Telemetry")
+	static bool StartTelemetry(const FString& Filename);
+
+	UFUNCTION(BlueprintCallable, Category = "Virtual Cursor|Telemetry")
+	static void StopTelemetry();
+
+	/** Returns false if no telemetry session is running. */
+	UFUNCTION(BlueprintPure, Category = "Virtual Cursor|Telemetry")
+	static bool GetTelemetryStats(int64& WrittenRecords, int64& DroppedRecords);
+
+	/** Returns the cursors' CPU time and deferred work over the last complete frame. BudgetMs is 0 if unlimited. */
+	UFUNCTION(BlueprintPure, Category = "Virtual Cursor|Performance")
+	static void GetFrameBudgetStats(float& UsedMs, float& BudgetMs, int32& DeferredHover, int32& DeferredOptional);
+
+	/** 
+	* Changes how cursors respond while hovering this widget or anything inside it: speed, drag and magnetism.
+	* Tags the widget's underlying Slate widget, so call it once the widget has been constructed, e.g. from Construct.
+	* Returns false if it hasn't been yet.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Virtual Cursor|Response")
+	static bool SetCursorResponseOverride(class UWidget* Widget, const FCursorResponseOverride& Response);
+
+	/** 
+	* Streams Assets in when a cursor heads for this widget, before it gets there, and keeps them loaded while the widget lives.
+	* Cursors also broadcast their manager's OnWidgetAboutToBeHovered for it. Needs UCursorSettings' bPrefetchHoverAssets.
+	* Like SetCursorResponseOverride, call it once the widget has been constructed. Returns false if it hasn't been yet.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Virtual Cursor|Prefetch")
+	static bool RegisterHoverPrefetch(class UWidget* Widget, const TArray<TSoftObjectPtr<UObject>>& Assets);
+
+	/** Returns how many widgets cursors were predicted to reach, how many hovers there were and how many of them were predicted. */
+	UFUNCTION(BlueprintPure, Category = "Virtual Cursor|Prefetch")
+	static void GetHoverPrefetchStats(int32& Predictions, int32& Hovers, int32& PredictedHovers);
+
+	/** Rebuilds every cursor's key bindings on its next input event. Call after changing input mappings at runtime. */
+	UFUNCTION(BlueprintCallable, Category = "Virtual Cursor|Bindings")
+	static void RefreshCursorKeyBindings();
 };
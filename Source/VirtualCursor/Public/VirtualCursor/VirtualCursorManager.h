@@ -2,12 +2,27 @@
 
 #include "CoreMinimal.h"
 #include "Subsystems/LocalPlayerSubsystem.h"
+#include "Engine/EngineTypes.h"
+#include "WorldCollision.h"
+#include "VirtualCursor/CursorHeatmap.h"
+#include "VirtualCursor/CursorSettings.h"
 #include "VirtualCursorManager.generated.h"
 
+class UWidget;
+
 DECLARE_LOG_CATEGORY_EXTERN(LogVirtualCursorManager, Log, All);
 
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnCursorWorldPick, const FHitResult&, HitResult);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnWidgetAboutToBeHovered, UWidget*, Widget, float, TimeToHover);
+
 
+class APawn;
+class APlayerController;
 class FExtendedAnalogCursor;
+class UCursorProfile;
+class UWidgetComponent;
+class UWidgetInteractionComponent;
 
 
 UCLASS(Blueprintable, BlueprintType)
@@ -37,14 +52,14 @@ public:
 
 	/** 
 	* Returns true if the analog cursor input preprocessor debug flag is on/off 
-	* Prints an onscreen debug message when a key/button is pressed
+	* Draws the cursor's trail, velocity, clamp bounds, hovered widget and key/button events in the debug overlay
 	*/
 	UFUNCTION(BlueprintPure, Category = "Cursor")
 	bool IsCursorDebugActive() const;
 
 	/** 
 	* Returns true if the analog cursor debug flag is on/off 
-	* Prints an onscreen debug message when an analog input occurs(for example: thumbstick on x/y)
+	* Adds analog input(for example: thumbstick on x/y) to the debug overlay
 	*/
 	UFUNCTION(BlueprintPure, Category = "Cursor")
 	bool IsAnalogDebugActive() const;
@@ -70,10 +85,222 @@ public:
 	UFUNCTION(BlueprintPure, Category = "Cursor")
 		bool CheckClampCursorToViewport() const;
 
+	/** 
+	* Tunes this player's cursor with Profile instead of the project settings. Null goes back to the settings.
+	* Takes effect immediately, also for a cursor created later. A cursor that survives map travel goes back to the settings.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Cursor")
+	void SetCursorProfile(UCursorProfile* Profile);
+
+	UFUNCTION(BlueprintPure, Category = "Cursor")
+	UCursorProfile* GetCursorProfile() const;
+
+	/** 
+	* Enables or disables magnetism: interactable widgets pull the moving cursor towards their centre and slow it down as it nears them.
+	* The field it samples is rebuilt on a worker thread when the layout changes, so it can lag a layout change by a few frames.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Cursor|Magnetism")
+	void SetMagnetismEnabled(bool bEnabled);
+
+	UFUNCTION(BlueprintPure, Category = "Cursor|Magnetism")
+	bool IsMagnetismEnabled() const;
+
+	/** 
+	* Sets what scrolls the scrollable widget under this player's cursor. Whether that input still reaches the game is up to SetInputConsumption.
+	* Defaults to UCursorSettings' DefaultAnalogScrollInput.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Cursor|Scrolling")
+	void SetAnalogScrollInput(ECursorScrollInput ScrollInput);
+
+	UFUNCTION(BlueprintPure, Category = "Cursor|Scrolling")
+	ECursorScrollInput GetAnalogScrollInput() const;
+
+	/** 
+	* Sets which of the inputs this player's cursor acts on stop at the cursor while their viewport is in Mode,
+	* instead of also being handled by widgets and the game. Defaults to UCursorSettings' policy for that mode.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Cursor|Input")
+	void SetInputConsumption(ECursorInputMode Mode, const FCursorInputConsumption& Consumption);
+
+	UFUNCTION(BlueprintPure, Category = "Cursor|Input")
+	FCursorInputConsumption GetInputConsumption(ECursorInputMode Mode) const;
+
+	/** Reports how many input events the consumption policy stopped at this player's cursor since the last reset */
+	UFUNCTION(BlueprintPure, Category = "Cursor|Input")
+	void GetAbsorbedInputCounts(int32& Movement, int32& Clicks, int32& Scroll, int32& OtherGamepadKeys) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Cursor|Input")
+	void ResetAbsorbedInputCounts();
+
+	/** 
+	* Reports how much the input conditioning pipeline filtered out since the last reset.
+	* SuppressedMoves counts frames the cursor was held on its pixel where the legacy dead zone alone would have moved it.
+	* SuppressedHoverChanges counts those that would have moved the cursor off the hovered widget.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Cursor|Conditioning")
+	void GetInputConditioningStats(int32& SuppressedMoves, int32& SuppressedHoverChanges) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Cursor|Conditioning")
+	void ResetInputConditioningStats();
+
+	/** 
+	* Enables or disables tracing into the world under this player's cursor.
+	* Traces are issued asynchronously together with every other player's and their results arrive a frame later through OnWorldPick.
+	* No trace is issued while neither the cursor nor the camera moves.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Cursor|World Pick")
+	void SetWorldPickEnabled(bool bEnabled, ECollisionChannel TraceChannel = ECC_Visibility, float TraceDistance = 100000.0f);
+
+	UFUNCTION(BlueprintPure, Category = "Cursor|World Pick")
+	bool IsWorldPickEnabled() const;
+
+	/** Returns the most recent world pick. False if there is none or nothing was hit. */
+	UFUNCTION(BlueprintPure, Category = "Cursor|World Pick")
+	bool GetWorldPickResult(FHitResult& OutHitResult) const;
+
+	/** Broadcast whenever a world pick under this player's cursor completes */
+	UPROPERTY(BlueprintAssignable, Category = "Cursor|World Pick")
+	FOnCursorWorldPick OnWorldPick;
+
+	/** 
+	* Broadcast when this player's cursor heads for a widget registered with UVirtualCursor::RegisterHoverPrefetch,
+	* with the seconds it would take to get there at its current velocity. Needs UCursorSettings' bPrefetchHoverAssets.
+	*/
+	UPROPERTY(BlueprintAssignable, Category = "Cursor|Prefetch")
+	FOnWidgetAboutToBeHovered OnWidgetAboutToBeHovered;
+
+	/** 
+	* Makes a world-space widget component hoverable and clickable by this player's cursor.
+	* Registered widgets are ray tested directly against their quad, before and instead of any physics trace.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Cursor|World Widgets")
+	void RegisterWidgetComponent(UWidgetComponent* WidgetComponent);
+
+	UFUNCTION(BlueprintCallable, Category = "Cursor|World Widgets")
+	void UnregisterWidgetComponent(UWidgetComponent* WidgetComponent);
+
+	/** Returns the registered widget component under the cursor, if any. */
+	UFUNCTION(BlueprintPure, Category = "Cursor|World Widgets")
+	UWidgetComponent* GetHoveredWidgetComponent() const;
+
+	/** 
+	* Starts or stops accumulating where this player's cursor dwells, travels and hovers, per top-level user widget.
+	* Enabling clears anything accumulated before.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Cursor|Heatmap")
+	void SetHeatmapEnabled(bool bEnabled);
+
+	UFUNCTION(BlueprintPure, Category = "Cursor|Heatmap")
+	bool IsHeatmapEnabled() const;
+
+	/** Returns the class names of every layout that has been accumulated so far. None is the bare viewport. */
+	UFUNCTION(BlueprintPure, Category = "Cursor|Heatmap")
+	void GetHeatmapLayouts(TArray<FName>& OutLayouts) const;
+
+	/**
+	* Copies one layout's dwell grid (seconds resting in each cell) and travel grid (seconds moving through each cell),
+	* both OutWidth by OutHeight and row major. Returns false, with both grids empty, if the layout has no data.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Cursor|Heatmap")
+	bool GetHeatmap(FName Layout, TArray<float>& OutDwellSeconds, TArray<float>& OutTravelSeconds, int32& OutWidth, int32& OutHeight) const;
+
+	/** Writes the heatmaps as PNGs and the hover times as CSV to Directory (Saved/VirtualCursor if empty), on a worker thread. */
+	UFUNCTION(BlueprintCallable, Category = "Cursor|Heatmap")
+	void ExportHeatmaps(const FString& Directory);
+
+	/** Called by FVirtualCursorTicker. Adds this frame's cursor state to the heatmaps. */
+	void AccumulateHeatmap(float DeltaTime);
+
+	/** Called by FVirtualCursorTicker. Reads the result of the trace issued last frame, if it has completed. */
+	void ConsumeWorldPick();
+
+	/** Called by FVirtualCursorTicker. Recomputes the cursor ray if a feature needs it and the cursor or camera moved. */
+	void UpdateCursorRay();
+
+	/** Called by FVirtualCursorTicker. Ray tests the registered widget components and drives the widget interaction pointer. */
+	void UpdateWorldWidgetHover();
+
+	/** Called by FVirtualCursorTicker. Issues a new trace if world picks are enabled and the cursor ray changed. */
+	void RequestWorldPick();
+
 protected:
 
+	/** Moves the Slate user's cursor to the center of this player's viewport. Returns the new absolute position. */
+	FVector2D CenterCursor() const;
+
+	/** 
+	* Gives this player's Slate user focus and mouse capture on their game viewport widget directly,
+	* without simulating any input. Returns false if the viewport widget could not be found.
+	*/
+	bool AcquireViewportFocusAndCapture() const;
 
 private:
 
+	/** Rebinds a surviving cursor to this player's new world after a map load. */
+	void HandlePostLoadMapWithWorld(UWorld* LoadedWorld);
+
+	/** Creates, or moves to the current player controller, the component that feeds world widgets our pointer. */
+	UWidgetInteractionComponent* GetOrCreateWidgetInteraction();
+
+	FDelegateHandle PostLoadMapHandle;
+
+	/** The cached world-space ray under the cursor, and the inputs it was computed from */
+	struct FCursorRay
+	{
+		FVector2D CursorPosition = FVector2D(FLT_MAX, FLT_MAX);
+		FVector CameraLocation = FVector::ZeroVector;
+		FRotator CameraRotation = FRotator::ZeroRotator;
+		FVector Origin = FVector::ZeroVector;
+		FVector Direction = FVector::ForwardVector;
+		bool bValid = false;
+	};
+
+	FCursorRay CursorRay;
+
+	/** True if CursorRay was recomputed this frame */
+	bool bCursorRayChanged = false;
+
+	bool bWorldPickEnabled = false;
+
+	/** Set when the pick settings change, so the next request traces even if the ray didn't move */
+	bool bWorldPickDirty = false;
+
+	TEnumAsByte<ECollisionChannel> WorldPickChannel = ECC_Visibility;
+
+	float WorldPickDistance = 100000.0f;
+
+	FTraceHandle PendingWorldPick;
+
+	FHitResult WorldPickResult;
+
+	bool bHeatmapEnabled = false;
+
+	bool bMagnetismEnabled = false;
+
+	ECursorScrollInput AnalogScrollInput = ECursorScrollInput::None;
+
+	FCursorInputConsumption InputConsumption[static_cast<uint8>(ECursorInputMode::Num)];
+
+	FCursorHeatmap Heatmap;
+
+	TArray<TWeakObjectPtr<UWidgetComponent>> WorldWidgets;
+
+	/** Set when WorldWidgets changes, so the cached widget hit is recomputed even if the ray didn't move */
+	bool bWorldWidgetsDirty = false;
+
+	/** The last ray/quad hit against WorldWidgets */
+	FHitResult WorldWidgetHit;
+
+	UPROPERTY(Transient)
+	UWidgetInteractionComponent* WidgetInteraction = nullptr;
+
+	/** The controller and pawn the world widget hit was last tested for, to notice possession changes */
+	TWeakObjectPtr<APlayerController> WidgetInteractionController;
+
+	TWeakObjectPtr<APawn> WidgetInteractionPawn;
+
+	UPROPERTY(Transient)
+	UCursorProfile* CursorProfile = nullptr;
+
 	TSharedPtr<FExtendedAnalogCursor> Cursor;
 };
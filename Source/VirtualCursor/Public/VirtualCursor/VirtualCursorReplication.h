@@ -0,0 +1,222 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "VirtualCursorReplication.generated.h"
+
+
+/**
+ * One player's cursor on the wire: position and velocity normalized to the player's viewport and quantized.
+ * From the owner to the server the position usually goes as a packed change from the previous state sent (see bDelta),
+ * otherwise it takes 16 bits per axis. A stopped cursor's velocity takes a single bit, a moving one's a packed integer per axis.
+ * The server resolves deltas before storing the state, so what it replicates to everyone else always carries the full position.
+ */
+USTRUCT()
+struct VIRTUALCURSOR_API FReplicatedCursorState
+{
+	GENERATED_BODY()
+
+	/** Quantization of the normalized velocity, in steps per viewport per second */
+	static constexpr float VelocityScale = 4096.0f;
+
+	/** Normalized position, 0 to 65535 across the viewport */
+	uint16 X = 0;
+	uint16 Y = 0;
+
+	/** Normalized velocity times VelocityScale */
+	int16 VelocityX = 0;
+	int16 VelocityY = 0;
+
+	/** Incremented by the sender for every state it sends, so receivers can drop reordered ones */
+	uint8 Sequence = 0;
+
+	bool bActive = false;
+
+	/** 
+	* True if the position travels as DeltaX/DeltaY from the state sent just before, whose Sequence is one less.
+	* Until ResolveDelta succeeds a received delta state has no position.
+	*/
+	bool bDelta = false;
+
+	/** Change in X and Y from the previous state, only meaningful while bDelta is set */
+	int32 DeltaX = 0;
+	int32 DeltaY = 0;
+
+	void Quantize(const FVector2D& ViewportPosition, const FVector2D& ViewportVelocity);
+
+	/** Sender. Sends the position as the change from Base, the state sent just before this one. */
+	void SetDeltaBase(const FReplicatedCursorState& Base);
+
+	/** Receiver. Rebuilds the position of a delta state from Base. False if Base is not the state the delta was made against. */
+	bool ResolveDelta(const FReplicatedCursorState& Base);
+
+	FORCEINLINE FVector2D GetViewportPosition() const
+	{
+		return FVector2D(X / 65535.0f, Y / 65535.0f);
+	}
+
+	FORCEINLINE FVector2D GetViewportVelocity() const
+	{
+		return FVector2D(VelocityX / VelocityScale, VelocityY / VelocityScale);
+	}
+
+	FORCEINLINE bool IsMoving() const
+	{
+		return VelocityX != 0 || VelocityY != 0;
+	}
+
+	/** True if the receiver would see the same cursor, ignoring Sequence */
+	FORCEINLINE bool Matches(const FReplicatedCursorState& Other) const
+	{
+		return X == Other.X && Y == Other.Y && VelocityX == Other.VelocityX && VelocityY == Other.VelocityY && bActive == Other.bActive;
+	}
+
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+	/** Size of this state once serialized, in bits. Computed from the layout NetSerialize writes. */
+	int32 GetSerializedBits() const;
+};
+
+template<>
+struct TStructOpsTypeTraits<FReplicatedCursorState> : public TStructOpsTypeTraitsBase2<FReplicatedCursorState>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+
+/**
+ * Shows a player's virtual cursor to everyone else in an online session.
+ * Add it to the PlayerState (or any actor owned by the player's controller). The owning client reads its cursor from
+ * FVirtualCursorStateBuffer and sends it to the server unreliably, only while it changes and more often the faster it moves.
+ * The server replicates it to everyone but the owner, who reconstruct it by interpolating between the states they received,
+ * or extrapolating from the latest one when the next is late.
+ */
+UCLASS(ClassGroup = (VirtualCursor), meta = (BlueprintSpawnableComponent))
+class VIRTUALCURSOR_API UVirtualCursorReplicationComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	UVirtualCursorReplicationComponent();
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** True on the machine whose local player owns this cursor */
+	UFUNCTION(BlueprintPure, Category = "Virtual Cursor|Replication")
+	bool IsLocalCursor() const;
+
+	/** 
+	* Where to draw this cursor, normalized to the viewport. On the owning machine it is the local cursor itself.
+	* Returns false if the cursor is disabled or nothing was received yet.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Virtual Cursor|Replication")
+	bool GetDisplayedCursor(FVector2D& ViewportPosition, FVector2D& ViewportVelocity) const;
+
+	/** 
+	* Cursor payload sent (owner) or received (everyone else) over the last second. Excludes RPC and packet headers.
+	* The owner's figure includes the delta coding, everyone else receives full positions from the server.
+	*/
+	UFUNCTION(BlueprintPure, Category = "Virtual Cursor|Replication")
+	float GetBytesPerSecond() const
+	{
+		return BytesPerSecond;
+	}
+
+	/** Sends per second while the cursor moves at SpeedForMaxSendRate or faster */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Virtual Cursor|Replication", meta = (ClampMin = "1.0"))
+	float MaxSendRate;
+
+	/** Sends per second while the cursor barely moves. Nothing is sent while it is still. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Virtual Cursor|Replication", meta = (ClampMin = "1.0"))
+	float MinSendRate;
+
+	/** Speed, in viewports per second, at which MaxSendRate is reached */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Virtual Cursor|Replication", meta = (ClampMin = "0.01"))
+	float SpeedForMaxSendRate;
+
+	/** How far behind the latest received state remote cursors are drawn, so there is usually a later state to interpolate to */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Virtual Cursor|Replication", meta = (ClampMin = "0.0"))
+	float InterpolationDelay;
+
+	/** 
+	* Longest the owner sends position deltas before it sends a full position again. Sends are unreliable, so after a lost one
+	* the server ignores deltas until the next full position, and remote cursors extrapolate meanwhile.
+	*/
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Virtual Cursor|Replication", meta = (ClampMin = "0.0"))
+	float KeyframeInterval;
+
+	/** Longest a remote cursor keeps moving on its last velocity before it stops to wait for the next state */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Virtual Cursor|Replication", meta = (ClampMin = "0.0"))
+	float MaxExtrapolation;
+
+protected:
+
+	UFUNCTION(Server, Unreliable)
+	void ServerSetCursorState(const FReplicatedCursorState& NewState);
+
+	UFUNCTION()
+	void OnRep_CursorState();
+
+private:
+
+	class APlayerController* FindOwningController() const;
+
+	/** Owner only. Sends the local cursor if it changed and the adaptive interval elapsed. */
+	void UpdateLocalCursor(double Time);
+
+	/** Everyone else. Queues a received state for reconstruction. */
+	void ReceiveState(const FReplicatedCursorState& State, double Time);
+
+	/** Everyone else. Interpolates or extrapolates the received states into DisplayedPosition. */
+	void ReconstructRemoteCursor(double Time);
+
+	void CountBits(int32 Bits);
+
+	UPROPERTY(ReplicatedUsing = OnRep_CursorState)
+	FReplicatedCursorState CursorState;
+
+	/** Owner: the last state sent */
+	FReplicatedCursorState LastSentState;
+
+	double LastSendTime = 0.0;
+
+	/** Owner: when a full position was last sent */
+	double LastKeyframeTime = 0.0;
+
+	/** Owner: true once a resting state was sent twice, in case the first one was lost */
+	bool bRestingStateRepeated = false;
+
+	struct FReceivedState
+	{
+		double Time = 0.0;
+		FVector2D Position = FVector2D::ZeroVector;
+		FVector2D Velocity = FVector2D::ZeroVector;
+		bool bActive = false;
+	};
+
+	static constexpr int32 ReceivedHistorySize = 8;
+
+	/** Ring of received states, ReceivedHead is the newest */
+	FReceivedState ReceivedHistory[ReceivedHistorySize];
+
+	int32 ReceivedHead = INDEX_NONE;
+
+	/** Sequence of the newest queued state. States that are not newer are dropped. */
+	uint8 LastReceivedSequence = 0;
+
+	/** Result of the reconstruction (or the local cursor on the owner) this frame */
+	FVector2D DisplayedPosition = FVector2D::ZeroVector;
+	FVector2D DisplayedVelocity = FVector2D::ZeroVector;
+	bool bDisplayed = false;
+
+	/** Bits counted in the current one second window, and the result of the last window */
+	int32 WindowBits = 0;
+	double WindowStart = 0.0;
+	float BytesPerSecond = 0.0f;
+};
@@ -4,6 +4,15 @@
 
 DECLARE_LOG_CATEGORY_EXTERN(LogVirtualCursor, Log, All);
 
+class FExtendedAnalogCursor;
+class FVirtualCursorTicker;
+class FVirtualCursorLoadingTick;
+class SVirtualCursorOverlay;
+class UGameInstance;
+class UGameViewportClient;
+class UWorld;
+class SWidget;
+
 
 /**
  * The public interface to this module
@@ -39,4 +48,115 @@ public:
 	{
 		return FModuleManager::Get().IsModuleLoaded("VirtualCursor");
 	}
+
+	/**
+	* Keeps a cursor alive after its manager has been destroyed so that the next manager created for the same
+	* controller in the same game instance can take it over with its position, velocity and flags intact.
+	* The cursor stops asking for a Slate cursor radius until it is ticked again.
+	*/
+	void ParkCursor(const UGameInstance* GameInstance, int32 ControllerId, const TSharedPtr<FExtendedAnalogCursor>& Cursor, bool bWasEnabled);
+
+	/** 
+	* Removes and returns the cursor parked for this controller in this game instance, if any.
+	* bOutWasEnabled is set to whether the cursor was registered with Slate when it was parked.
+	*/
+	TSharedPtr<FExtendedAnalogCursor> ClaimParkedCursor(const UGameInstance* GameInstance, int32 ControllerId, bool& bOutWasEnabled);
+
+	/** Destroys every parked cursor. */
+	void ClearParkedCursors();
+
+	/** The ticker that runs the per-frame features of all cursor managers. Only valid between startup and shutdown. */
+	FVirtualCursorTicker& GetTicker() const
+	{
+		check(Ticker.IsValid());
+		return *Ticker;
+	}
+
+	/** Adds this viewport's cursor overlay to it, or moves it to ZOrder if it is already shown. */
+	void ShowCursorOverlay(UGameViewportClient* ViewportClient, int32 ZOrder);
+
+	/** Removes this viewport's cursor overlay from it. Per-player brushes are kept. */
+	void HideCursorOverlay(UGameViewportClient* ViewportClient);
+
+	/** The widget that draws the cursors of this viewport's local players, created on first use */
+	SVirtualCursorOverlay& GetCursorOverlay(UGameViewportClient* ViewportClient);
+
+	/** 
+	* Adds this viewport's debug overlay to it while any of its local players' cursors has debugging on, and removes it once none has.
+	* Does nothing in builds without WITH_VIRTUALCURSOR_DEBUG.
+	*/
+	void RefreshDebugOverlay(UGameViewportClient* ViewportClient);
+
+	/** A new cursor overlay for widget trees other than the game viewport, such as a MoviePlayer loading screen */
+	TSharedRef<SWidget> MakeCursorOverlay() const;
+
+	/**
+	* Hands the physics of every enabled cursor to a separate thread, so they keep moving while the game thread is blocked.
+	* Called on PreLoadMap and when the MoviePlayer prepares its loading screen, if UCursorSettings::bTickDuringLoads is set.
+	*/
+	void BeginLoadingTick();
+
+	/** Stops the loading thread and hands the cursors back to their normal Tick. */
+	void EndLoadingTick();
+
+private:
+
+	TSharedPtr<FVirtualCursorTicker> Ticker;
+
+	TSharedPtr<FVirtualCursorLoadingTick> LoadingTick;
+
+	void HandlePreLoadMap(const FString& MapName);
+	void HandlePostLoadMapWithWorld(UWorld* LoadedWorld);
+
+	/** Destroys the cursors parked by game instances that are gone, or that no longer have a local player to claim them */
+	void HandleWorldCleanup(UWorld* World, bool bSessionEnded, bool bCleanupResources);
+
+#if WITH_EDITOR
+	/** Invalidates the cursors' key bindings when the input mappings are edited */
+	void HandleObjectPropertyChanged(UObject* Object, struct FPropertyChangedEvent& PropertyChangedEvent);
+
+	FDelegateHandle ObjectPropertyChangedHandle;
+#endif
+
+	FDelegateHandle PreLoadMapHandle;
+	FDelegateHandle PostLoadMapHandle;
+	FDelegateHandle WorldCleanupHandle;
+	FDelegateHandle PrepareLoadingScreenHandle;
+	FDelegateHandle MoviePlaybackFinishedHandle;
+
+	struct FCursorOverlay
+	{
+		TWeakObjectPtr<UGameViewportClient> ViewportClient;
+		TSharedPtr<SVirtualCursorOverlay> Widget;
+
+		/** True while Widget is added to ViewportClient */
+		bool bShown = false;
+	};
+
+	/** One per game viewport client, so every PIE window draws its own players */
+	TArray<FCursorOverlay> CursorOverlays;
+
+	FCursorOverlay& FindOrAddCursorOverlay(UGameViewportClient* ViewportClient);
+
+	struct FDebugOverlay
+	{
+		TWeakObjectPtr<UGameViewportClient> ViewportClient;
+		TSharedPtr<SWidget> Widget;
+	};
+
+	/** Shown debug overlays, one per viewport with a player being debugged, like CursorOverlays */
+	TArray<FDebugOverlay> DebugOverlays;
+
+	struct FParkedCursor
+	{
+		/** Controller ids restart at 0 in every PIE instance, so a cursor is only handed back within its game instance */
+		TWeakObjectPtr<const UGameInstance> GameInstance;
+		int32 ControllerId = INDEX_NONE;
+
+		TSharedPtr<FExtendedAnalogCursor> Cursor;
+		bool bWasEnabled = false;
+	};
+
+	/** Cursors that outlived their manager */
+	TArray<FParkedCursor> ParkedCursors;
 };
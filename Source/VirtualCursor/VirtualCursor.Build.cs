@@ -26,7 +26,15 @@ public class VirtualCursor : ModuleRules
             new string[] {
                 "Slate",
                 "SlateCore",
-                "UMG"
+                "UMG",
+                "ImageWrapper",
+                "MoviePlayer"
             });
+
+        // The multi-client automation test starts its own play session
+        if (Target.bBuildEditor)
+        {
+            PrivateDependencyModuleNames.Add("UnrealEd");
+        }
 	}
 }